@@ -0,0 +1,672 @@
+#include "scene_handler_config.h"
+
+#if SCENE_HANDLER_INSTRUMENTATION
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#if SCENE_HANDLER_THREADING
+#include <pthread.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "frame_capture.h"
+#include "memory_tracker.h"
+
+//  Constants from OpenGL
+#define GL_COLOR_BUFFER_BIT 0x00004000
+
+//  A frame is read back this many frames after its GPU copy was issued, by when the copy has completed
+#define CAPTURE_RING_SIZE 3
+#define MAX_CAPTURE_JOBS 16
+#define MAX_CAPTURE_PATH_LEN 256
+
+typedef enum
+{
+    JOB_FREE = 0,
+    JOB_PENDING,
+    JOB_DONE
+} JOB_STATE;
+
+typedef struct
+{
+    JOB_STATE state;
+    Image image;
+    size_t bytes;
+    CAPTURE_FORMAT format;
+    char path[MAX_CAPTURE_PATH_LEN];
+} CAPTURE_JOB;
+
+typedef struct
+{
+    Image image;
+    double time;
+} REPLAY_FRAME;
+
+//  A saved replay window, the ring's frames are handed over whole so saving never waits on the files
+typedef struct
+{
+    JOB_STATE state;
+    REPLAY_FRAME *frames;
+    int capacity;
+    int first;
+    int count;
+    int written;
+    CAPTURE_FORMAT format;
+    char directory[MAX_CAPTURE_PATH_LEN];
+} SAVE_JOB;
+
+static RenderTexture2D capture_ring[CAPTURE_RING_SIZE];
+static bool capture_ring_filled[CAPTURE_RING_SIZE];
+static double capture_ring_time[CAPTURE_RING_SIZE];
+static int capture_frame_count = 0;
+
+static bool recording = false;
+static CAPTURE_FORMAT recording_format;
+static char recording_directory[MAX_CAPTURE_PATH_LEN];
+static int recorded_frames = 0;
+
+//  Set when a recording ended itself, until stop_frame_recording() releases what it used
+static bool recording_stopped = false;
+
+//  Jobs are owned by the main thread unless pending, it also does all of the memory tracking
+static CAPTURE_JOB jobs[MAX_CAPTURE_JOBS];
+static int job_head = 0;
+static SAVE_JOB save_job;
+#if SCENE_HANDLER_THREADING
+static int job_tail = 0;
+static pthread_t worker;
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_done = PTHREAD_COND_INITIALIZER;
+static bool worker_running = false;
+static bool worker_stopping = false;
+#endif
+
+static bool replaying = false;
+static float replay_seconds;
+static REPLAY_FRAME *replay_frames = NULL;
+static int replay_capacity = 0;
+static int replay_count = 0;
+static int replay_next = 0;
+
+static bool start_worker(void);
+static void stop_worker(void);
+#if SCENE_HANDLER_THREADING
+static void *run_worker(void *unused);
+#endif
+static void write_frame(const CAPTURE_JOB *job);
+static void write_saved_frame(SAVE_JOB *job);
+static void queue_job(Image image, CAPTURE_FORMAT format, const char *path);
+static void release_done_jobs(void);
+static void flush_capture_ring(void);
+static void read_back_slot(int slot);
+static void store_replay_frame(Image frame, double time);
+static void release_replay_frames(REPLAY_FRAME *frames, int capacity);
+static void release_capture_ring(void);
+static bool is_capturing(void);
+static bool format_frame_path(char *path, const char *directory, int frame, Image image, CAPTURE_FORMAT format);
+
+
+//  Refused when the directory leaves no room for the frame names
+bool start_frame_recording(const char *directory, CAPTURE_FORMAT format)
+{
+    char path[MAX_CAPTURE_PATH_LEN];
+    Image frame = (Image){ .width = GetRenderWidth(), .height = GetRenderHeight() };
+
+    if (recording || format_frame_path(path, directory, 0, frame, format) == false || start_worker() == false)
+    {
+        return false;
+    }
+
+    //  Fits, as the frame path it starts did
+    strcpy(recording_directory, directory);
+    recording_format = format;
+    recorded_frames = 0;
+    recording = true;
+    recording_stopped = false;
+
+    return true;
+}
+
+void stop_frame_recording(void)
+{
+    if (recording == false && recording_stopped == false)
+    {
+        return;
+    }
+
+    flush_capture_ring();
+    recording = false;
+    recording_stopped = false;
+
+    if (replaying == false)
+    {
+        release_capture_ring();
+    }
+
+    stop_worker();
+}
+
+bool is_frame_recording_active(void)
+{
+    return recording;
+}
+
+bool start_replay_capture(float seconds, size_t max_bytes)
+{
+    size_t frame_bytes = (size_t)GetPixelDataSize(GetRenderWidth(), GetRenderHeight(), PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    if (replaying || frame_bytes == 0 || max_bytes < frame_bytes)
+    {
+        return false;
+    }
+
+    replay_capacity = (int)(max_bytes / frame_bytes);
+    replay_frames = calloc(replay_capacity, sizeof(REPLAY_FRAME));
+
+    if (replay_frames == NULL)
+    {
+        return false;
+    }
+
+    replay_seconds = seconds;
+    replay_count = 0;
+    replay_next = 0;
+    replaying = true;
+
+    return true;
+}
+
+//  Hands the frames from the last few seconds to be written, returning how many there were
+//  It stops at the first frame whose path would be truncated, and saves nothing while an earlier save is still being written
+int save_replay_capture(const char *directory, CAPTURE_FORMAT format)
+{
+    char path[MAX_CAPTURE_PATH_LEN];
+    int first = -1;
+    int saved = 0;
+
+    release_done_jobs();
+
+    if (replaying == false || start_worker() == false)
+    {
+        return 0;
+    }
+
+    flush_capture_ring();
+
+    double newest_time = replay_frames[(replay_next + replay_capacity - 1) % replay_capacity].time;
+
+    //  Oldest first, so the frames in the window follow on from each other
+    for (int count = 0; count < replay_count; count++)
+    {
+        int pos = (replay_next + replay_capacity - replay_count + count) % replay_capacity;
+
+        if (newest_time - replay_frames[pos].time > replay_seconds)
+        {
+            continue;
+        }
+
+        if (format_frame_path(path, directory, saved, replay_frames[pos].image, format) == false)
+        {
+            break;
+        }
+
+        first = (first < 0) ? pos : first;
+        saved++;
+    }
+
+    REPLAY_FRAME *empty_frames = calloc(replay_capacity, sizeof(REPLAY_FRAME));
+
+    if (saved == 0 || empty_frames == NULL)
+    {
+        free(empty_frames);
+        return 0;
+    }
+
+#if SCENE_HANDLER_THREADING
+    pthread_mutex_lock(&job_lock);
+
+    if (save_job.state != JOB_FREE)
+    {
+        pthread_mutex_unlock(&job_lock);
+        free(empty_frames);
+        return 0;
+    }
+#endif
+
+    //  The ring starts again with no frames, and fills back up while the old one is written
+    save_job = (SAVE_JOB){ JOB_PENDING, replay_frames, replay_capacity, first, saved, 0, format, { 0 } };
+    strcpy(save_job.directory, directory);
+
+    replay_frames = empty_frames;
+    replay_count = 0;
+    replay_next = 0;
+
+#if SCENE_HANDLER_THREADING
+    pthread_cond_signal(&job_ready);
+    pthread_mutex_unlock(&job_lock);
+#else
+    while (save_job.state == JOB_PENDING)
+    {
+        write_saved_frame(&save_job);
+    }
+
+    release_done_jobs();
+#endif
+
+    return saved;
+}
+
+void stop_replay_capture(void)
+{
+    if (replaying == false)
+    {
+        return;
+    }
+
+    release_replay_frames(replay_frames, replay_capacity);
+    replay_frames = NULL;
+    replay_capacity = 0;
+    replaying = false;
+
+    //  Waits for any saved frames still being written
+    if (recording == false)
+    {
+        release_capture_ring();
+        stop_worker();
+    }
+}
+
+bool is_replay_capture_active(void)
+{
+    return replaying;
+}
+
+void capture_frame(void)
+{
+    int width = GetRenderWidth();
+    int height = GetRenderHeight();
+    int slot = capture_frame_count % CAPTURE_RING_SIZE;
+
+    if (is_capturing() == false)
+    {
+        return;
+    }
+
+    release_done_jobs();
+
+    //  Make sure everything for this frame has been drawn before copying it
+    rlDrawRenderBatchActive();
+
+    if (capture_ring_filled[slot])
+    {
+        read_back_slot(slot);
+    }
+
+    if (capture_ring[slot].id == 0 || capture_ring[slot].texture.width != width || capture_ring[slot].texture.height != height)
+    {
+        unload_render_target(&capture_ring[slot]);
+        capture_ring[slot] = load_render_target(width, height);
+    }
+
+    //  A GPU side copy, so nothing waits on the frame being finished
+    rlBindFramebuffer(RL_READ_FRAMEBUFFER, 0);
+    rlBindFramebuffer(RL_DRAW_FRAMEBUFFER, capture_ring[slot].id);
+    rlBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT);
+    rlBindFramebuffer(RL_READ_FRAMEBUFFER, 0);
+    rlBindFramebuffer(RL_DRAW_FRAMEBUFFER, 0);
+
+    capture_ring_filled[slot] = true;
+    capture_ring_time[slot] = GetTime();
+    capture_frame_count++;
+}
+
+#if SCENE_HANDLER_THREADING
+static bool start_worker(void)
+{
+    if (worker_running)
+    {
+        return true;
+    }
+
+    worker_stopping = false;
+
+    if (pthread_create(&worker, NULL, &run_worker, NULL) != 0)
+    {
+        return false;
+    }
+
+    worker_running = true;
+
+    return true;
+}
+
+//  Any pending jobs are written before the worker exits
+static void stop_worker(void)
+{
+    if (worker_running == false)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&job_lock);
+    worker_stopping = true;
+    pthread_cond_broadcast(&job_ready);
+    pthread_mutex_unlock(&job_lock);
+
+    pthread_join(worker, NULL);
+    worker_running = false;
+
+    release_done_jobs();
+}
+
+static void *run_worker(void *unused)
+{
+    (void)unused;
+
+    pthread_mutex_lock(&job_lock);
+
+    while (true)
+    {
+        while (jobs[job_tail].state != JOB_PENDING && save_job.state != JOB_PENDING && worker_stopping == false)
+        {
+            pthread_cond_wait(&job_ready, &job_lock);
+        }
+
+        //  A saved frame at a time in between the recording's, as the main thread waits on those
+        if (jobs[job_tail].state != JOB_PENDING && save_job.state == JOB_PENDING)
+        {
+            pthread_mutex_unlock(&job_lock);
+            write_saved_frame(&save_job);
+            pthread_mutex_lock(&job_lock);
+            continue;
+        }
+
+        if (jobs[job_tail].state != JOB_PENDING)
+        {
+            break;
+        }
+
+        CAPTURE_JOB *job = &jobs[job_tail];
+
+        pthread_mutex_unlock(&job_lock);
+        write_frame(job);
+        pthread_mutex_lock(&job_lock);
+
+        job->state = JOB_DONE;
+        job_tail = (job_tail + 1) % MAX_CAPTURE_JOBS;
+        pthread_cond_broadcast(&job_done);
+    }
+
+    pthread_mutex_unlock(&job_lock);
+
+    return NULL;
+}
+
+//  Blocks when the worker is behind, as dropping frames would spoil a recording
+static void queue_job(Image image, CAPTURE_FORMAT format, const char *path)
+{
+    pthread_mutex_lock(&job_lock);
+
+    while (jobs[job_head].state == JOB_PENDING)
+    {
+        pthread_cond_wait(&job_done, &job_lock);
+    }
+
+    CAPTURE_JOB *job = &jobs[job_head];
+
+    if (job->state == JOB_DONE)
+    {
+        track_memory_free(MEMORY_CAPTURE, job->bytes);
+        UnloadImage(job->image);
+    }
+
+    job->image = image;
+    job->bytes = GetPixelDataSize(image.width, image.height, image.format);
+    job->format = format;
+    strcpy(job->path, path);
+    job->state = JOB_PENDING;
+    track_memory_alloc(MEMORY_CAPTURE, job->bytes);
+
+    job_head = (job_head + 1) % MAX_CAPTURE_JOBS;
+    pthread_cond_signal(&job_ready);
+
+    pthread_mutex_unlock(&job_lock);
+}
+#else
+static bool start_worker(void)
+{
+    return true;
+}
+
+static void stop_worker(void)
+{
+    release_done_jobs();
+}
+
+//  Without the worker each frame is written as it is read back, which stalls that frame
+static void queue_job(Image image, CAPTURE_FORMAT format, const char *path)
+{
+    CAPTURE_JOB *job = &jobs[job_head];
+
+    if (job->state == JOB_DONE)
+    {
+        track_memory_free(MEMORY_CAPTURE, job->bytes);
+        UnloadImage(job->image);
+    }
+
+    job->image = image;
+    job->bytes = GetPixelDataSize(image.width, image.height, image.format);
+    job->format = format;
+    strcpy(job->path, path);
+    track_memory_alloc(MEMORY_CAPTURE, job->bytes);
+
+    write_frame(job);
+    job->state = JOB_DONE;
+
+    job_head = (job_head + 1) % MAX_CAPTURE_JOBS;
+}
+#endif
+
+static void write_frame(const CAPTURE_JOB *job)
+{
+    if (job->format == CAPTURE_FORMAT_PNG)
+    {
+        ExportImage(job->image, job->path);
+        return;
+    }
+
+    FILE *file = fopen(job->path, "wb");
+
+    if (file != NULL)
+    {
+        fwrite(job->image.data, 1, job->bytes, file);
+        fclose(file);
+    }
+}
+
+//  Only the worker, or the main thread without one, touches a pending save
+static void write_saved_frame(SAVE_JOB *job)
+{
+    CAPTURE_JOB frame_job = { JOB_PENDING, job->frames[(job->first + job->written) % job->capacity].image, 0, job->format, { 0 } };
+
+    frame_job.bytes = GetPixelDataSize(frame_job.image.width, frame_job.image.height, frame_job.image.format);
+
+    //  Checked to fit when the save was made
+    if (format_frame_path(frame_job.path, job->directory, job->written, frame_job.image, job->format))
+    {
+        write_frame(&frame_job);
+    }
+
+#if SCENE_HANDLER_THREADING
+    pthread_mutex_lock(&job_lock);
+#endif
+
+    job->written++;
+
+    if (job->written == job->count)
+    {
+        job->state = JOB_DONE;
+    }
+
+#if SCENE_HANDLER_THREADING
+    pthread_mutex_unlock(&job_lock);
+#endif
+}
+
+static void release_done_jobs(void)
+{
+#if SCENE_HANDLER_THREADING
+    pthread_mutex_lock(&job_lock);
+#endif
+
+    for (int pos = 0; pos < MAX_CAPTURE_JOBS; pos++)
+    {
+        if (jobs[pos].state == JOB_DONE)
+        {
+            track_memory_free(MEMORY_CAPTURE, jobs[pos].bytes);
+            UnloadImage(jobs[pos].image);
+            jobs[pos] = (CAPTURE_JOB){ 0 };
+        }
+    }
+
+    if (save_job.state == JOB_DONE)
+    {
+        release_replay_frames(save_job.frames, save_job.capacity);
+        save_job = (SAVE_JOB){ 0 };
+    }
+
+#if SCENE_HANDLER_THREADING
+    pthread_mutex_unlock(&job_lock);
+#endif
+}
+
+//  Reads back everything still in flight, oldest first
+static void flush_capture_ring(void)
+{
+    for (int count = 0; count < CAPTURE_RING_SIZE; count++)
+    {
+        int slot = (capture_frame_count + count) % CAPTURE_RING_SIZE;
+
+        if (capture_ring_filled[slot])
+        {
+            read_back_slot(slot);
+        }
+    }
+}
+
+static void read_back_slot(int slot)
+{
+    char path[MAX_CAPTURE_PATH_LEN];
+    Image frame = LoadImageFromTexture(capture_ring[slot].texture);
+
+    capture_ring_filled[slot] = false;
+
+    // RenderTextures have an opposite Y axis
+    ImageFlipVertical(&frame);
+
+    if (replaying)
+    {
+        store_replay_frame(frame, capture_ring_time[slot]);
+    }
+
+    //  A path that no longer fits, after the window grew or the frame count gained a digit, ends the recording
+    if (recording && format_frame_path(path, recording_directory, recorded_frames, frame, recording_format) == false)
+    {
+        recording_stopped = true;
+        recording = false;
+    }
+
+    if (recording)
+    {
+        queue_job(frame, recording_format, path);
+        recorded_frames++;
+    }
+    else
+    {
+        UnloadImage(frame);
+    }
+}
+
+//  The ring reuses its images, so memory stays at what was allocated for the first lap
+static void store_replay_frame(Image frame, double time)
+{
+    REPLAY_FRAME *replay_frame = &replay_frames[replay_next];
+    size_t frame_bytes = GetPixelDataSize(frame.width, frame.height, frame.format);
+
+    if (replay_frame->image.data != NULL && (replay_frame->image.width != frame.width || replay_frame->image.height != frame.height || replay_frame->image.format != frame.format))
+    {
+        track_memory_free(MEMORY_CAPTURE, GetPixelDataSize(replay_frame->image.width, replay_frame->image.height, replay_frame->image.format));
+        UnloadImage(replay_frame->image);
+        replay_frame->image = (Image){ 0 };
+    }
+
+    if (replay_frame->image.data == NULL)
+    {
+        replay_frame->image = ImageCopy(frame);
+        track_memory_alloc(MEMORY_CAPTURE, frame_bytes);
+    }
+    else
+    {
+        memcpy(replay_frame->image.data, frame.data, frame_bytes);
+    }
+
+    replay_frame->time = time;
+    replay_next = (replay_next + 1) % replay_capacity;
+
+    if (replay_count < replay_capacity)
+    {
+        replay_count++;
+    }
+}
+
+static void release_replay_frames(REPLAY_FRAME *frames, int capacity)
+{
+    for (int pos = 0; pos < capacity; pos++)
+    {
+        if (frames[pos].image.data != NULL)
+        {
+            track_memory_free(MEMORY_CAPTURE, GetPixelDataSize(frames[pos].image.width, frames[pos].image.height, frames[pos].image.format));
+            UnloadImage(frames[pos].image);
+        }
+    }
+
+    free(frames);
+}
+
+static void release_capture_ring(void)
+{
+    for (int slot = 0; slot < CAPTURE_RING_SIZE; slot++)
+    {
+        unload_render_target(&capture_ring[slot]);
+
+        capture_ring_filled[slot] = false;
+    }
+}
+
+static bool is_capturing(void)
+{
+    return recording || replaying;
+}
+
+//  False when the path would be truncated
+static bool format_frame_path(char *path, const char *directory, int frame, Image image, CAPTURE_FORMAT format)
+{
+    int length;
+
+    if (format == CAPTURE_FORMAT_PNG)
+    {
+        length = snprintf(path, MAX_CAPTURE_PATH_LEN, "%s/frame_%06d.png", directory, frame);
+    }
+    else
+    {
+        length = snprintf(path, MAX_CAPTURE_PATH_LEN, "%s/frame_%06d_%dx%d.rgba", directory, frame, image.width, image.height);
+    }
+
+    return length >= 0 && length < MAX_CAPTURE_PATH_LEN;
+}
+
+#endif
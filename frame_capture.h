@@ -0,0 +1,36 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "scene_handler_config.h"
+
+//  Frames are copied on the GPU and read back a few frames later, files are written by a worker thread when built with threading
+typedef enum
+{
+    CAPTURE_FORMAT_RAW = 0,
+    CAPTURE_FORMAT_PNG
+} CAPTURE_FORMAT;
+
+#if SCENE_HANDLER_INSTRUMENTATION
+//  A recording ends itself if a frame's path grows too long, stop_frame_recording() is still needed to release it
+bool start_frame_recording(const char *directory, CAPTURE_FORMAT format);
+void stop_frame_recording(void);
+bool is_frame_recording_active(void);
+
+//  Keeps the last few seconds in memory, bounded by max_bytes, until saved or stopped
+//  Saving hands those frames to the background and starts an empty buffer, so up to twice max_bytes is held until
+//  they are written, a save made before then returns 0, and stop_replay_capture() waits for them to finish
+bool start_replay_capture(float seconds, size_t max_bytes);
+int save_replay_capture(const char *directory, CAPTURE_FORMAT format);
+void stop_replay_capture(void);
+bool is_replay_capture_active(void);
+
+//  Call just before EndDrawing(), the transition handler does this for its own frames
+void capture_frame(void);
+#else
+#define capture_frame() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,460 @@
+#include "scene_handler_config.h"
+
+#if SCENE_HANDLER_INSTRUMENTATION
+
+#include <raylib.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "input_recorder.h"
+#include "memory_tracker.h"
+#include "scene_handler.h"
+
+#define RECORDING_MAGIC 0x494E5053u
+#define RECORDING_VERSION 1
+#define MAX_INPUT_EVENTS 16384
+#define MAX_RECORDED_SCENE_CHANGES 1024
+#define INITIAL_RECORDED_FRAMES 1024
+
+typedef enum
+{
+    SESSION_NONE = 0,
+    SESSION_RECORDING,
+    SESSION_REPLAYING
+} SESSION_STATE;
+
+//  Fixed width fields, followed by the frame times, the scene changes and raylib's automation events
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_frames;
+    uint32_t num_scene_changes;
+    uint32_t num_events;
+    uint32_t reserved;
+} RECORDING_HEADER;
+
+//  frame is the frame the change is made before, changes made during a frame are replayed before the following one
+typedef struct
+{
+    uint32_t frame;
+    int32_t change;
+    int32_t scene_pos;
+} RECORDED_SCENE_CHANGE;
+
+static SESSION_STATE session = SESSION_NONE;
+static uint32_t frame = 0;
+static bool in_frame = false;
+static double input_clock = 0.0;
+static float input_frame_time = 0.0f;
+static double frame_start_time = 0.0;
+
+//  Set when the session outgrew its buffers, so the recording is refused rather than replayed wrongly
+static bool recording_overflowed = false;
+
+static float *frame_times = NULL;
+static uint32_t num_frames = 0;
+static uint32_t frame_capacity = 0;
+
+static RECORDED_SCENE_CHANGE scene_changes[MAX_RECORDED_SCENE_CHANGES];
+static uint32_t num_scene_changes = 0;
+static uint32_t next_scene_change = 0;
+
+static AutomationEventList events = { 0 };
+static uint32_t next_event = 0;
+
+static FILE *report = NULL;
+
+static void start_session(SESSION_STATE state);
+static void end_session(void);
+#if SCENE_HANDLER_TRANSITIONS
+static double get_input_clock(void);
+#endif
+static void add_frame_time(float frame_time);
+static bool write_recording(const char *path);
+static bool read_recording(const char *path);
+static void release_recording(void);
+
+
+//  Sessions start between transitions, as a running one is timed on GetTime()
+bool start_input_recording(void)
+{
+#if SCENE_HANDLER_TRANSITIONS
+    if (is_transition_active())
+    {
+        return false;
+    }
+#endif
+
+    if (session != SESSION_NONE)
+    {
+        return false;
+    }
+
+    release_recording();
+
+    events.events = malloc(MAX_INPUT_EVENTS * sizeof(AutomationEvent));
+
+    if (events.events == NULL)
+    {
+        return false;
+    }
+
+    events.capacity = MAX_INPUT_EVENTS;
+    events.count = 0;
+
+    SetAutomationEventList(&events);
+    SetAutomationEventBaseFrame(0);
+    StartAutomationEventRecording();
+
+    start_session(SESSION_RECORDING);
+
+    return true;
+}
+
+bool stop_input_recording(const char *path)
+{
+    if (session != SESSION_RECORDING)
+    {
+        return false;
+    }
+
+    StopAutomationEventRecording();
+    end_session();
+
+    //  raylib stops adding events once the list is full without saying so, so a full list may have lost some
+    if (events.count >= events.capacity)
+    {
+        recording_overflowed = true;
+    }
+
+    bool written = write_recording(path);
+
+    release_recording();
+
+    return written;
+}
+
+bool is_input_recording_active(void)
+{
+    return session == SESSION_RECORDING;
+}
+
+bool start_input_replay(const char *path, const char *report_path)
+{
+#if SCENE_HANDLER_TRANSITIONS
+    if (is_transition_active())
+    {
+        return false;
+    }
+#endif
+
+    if (session != SESSION_NONE)
+    {
+        return false;
+    }
+
+    release_recording();
+
+    if (read_recording(path) == false)
+    {
+        release_recording();
+        return false;
+    }
+
+    if (report_path != NULL)
+    {
+        report = fopen(report_path, "w");
+
+        if (report == NULL)
+        {
+            release_recording();
+            return false;
+        }
+
+        fprintf(report, "frame,clock,frame_ms,scene,transition,quality,live_bytes,high_water_bytes\n");
+    }
+
+    //  So the high water marks in the report are the replay's own
+    reset_memory_high_water();
+    start_session(SESSION_REPLAYING);
+
+    return true;
+}
+
+void stop_input_replay(void)
+{
+    if (session != SESSION_REPLAYING)
+    {
+        return;
+    }
+
+    end_session();
+
+    if (report != NULL)
+    {
+        fclose(report);
+        report = NULL;
+    }
+
+    release_recording();
+}
+
+bool is_input_replay_active(void)
+{
+    return session == SESSION_REPLAYING;
+}
+
+bool is_input_session_active(void)
+{
+    return session != SESSION_NONE;
+}
+
+//  False while replaying, the change is then ignored as the recording makes its own
+bool record_scene_change(SCENE_CHANGE change, int scene_pos)
+{
+    if (session == SESSION_REPLAYING)
+    {
+        return false;
+    }
+
+    if (session == SESSION_RECORDING)
+    {
+        if (num_scene_changes < MAX_RECORDED_SCENE_CHANGES)
+        {
+            scene_changes[num_scene_changes++] = (RECORDED_SCENE_CHANGE){ frame + (in_frame ? 1 : 0), change, scene_pos };
+        }
+        else
+        {
+            recording_overflowed = true;
+        }
+    }
+
+    return true;
+}
+
+bool take_replayed_scene_change(SCENE_CHANGE *change, int *scene_pos)
+{
+    if (session != SESSION_REPLAYING || next_scene_change >= num_scene_changes || scene_changes[next_scene_change].frame > frame)
+    {
+        return false;
+    }
+
+    *change = (SCENE_CHANGE)scene_changes[next_scene_change].change;
+    *scene_pos = scene_changes[next_scene_change].scene_pos;
+    next_scene_change++;
+
+    return true;
+}
+
+void begin_input_frame(int scene_pos)
+{
+    frame_start_time = GetTime();
+
+    //  A session started after the first scene was set replays from that scene
+    if (session == SESSION_RECORDING && frame == 0 && num_scene_changes == 0 && scene_pos != NO_SCENE)
+    {
+        record_scene_change(SCENE_CHANGE_SET, scene_pos);
+    }
+}
+
+//  Events are played before the scene runs, as raylib records the input each frame consumed
+void step_input_frame(void)
+{
+    float frame_time;
+
+    if (session == SESSION_RECORDING)
+    {
+        frame_time = GetFrameTime();
+        add_frame_time(frame_time);
+    }
+    else
+    {
+        frame_time = frame_times[frame];
+
+        while (next_event < events.count && events.events[next_event].frame <= frame)
+        {
+            PlayAutomationEvent(events.events[next_event++]);
+        }
+    }
+
+    input_clock += frame_time;
+    input_frame_time = frame_time;
+    in_frame = true;
+}
+
+//  The frame time step_input_frame() last took, recorded or replayed
+float get_input_frame_time(void)
+{
+    return input_frame_time;
+}
+
+void end_input_frame(int scene_pos)
+{
+    double frame_ms = (GetTime() - frame_start_time) * 1000.0;
+
+    in_frame = false;
+    frame++;
+
+    if (session != SESSION_REPLAYING)
+    {
+        return;
+    }
+
+    if (report != NULL)
+    {
+        MEMORY_USAGE usage = get_memory_usage(MEMORY_ALL);
+        int transition = 0;
+        int quality = 0;
+
+#if SCENE_HANDLER_TRANSITIONS
+        transition = is_transition_active();
+        quality = get_transition_quality();
+#endif
+
+        fprintf(report, "%u,%.6f,%.3f,%d,%d,%d,%zu,%zu\n", frame - 1, input_clock, frame_ms, scene_pos, transition, quality, usage.live_bytes, usage.high_water_bytes);
+    }
+
+    if (frame >= num_frames)
+    {
+        stop_input_replay();
+    }
+}
+
+static void start_session(SESSION_STATE state)
+{
+    session = state;
+    frame = 0;
+    in_frame = false;
+    input_clock = 0.0;
+    input_frame_time = 0.0f;
+    next_scene_change = 0;
+    next_event = 0;
+
+#if SCENE_HANDLER_TRANSITIONS
+    set_transition_clock(&get_input_clock);
+#endif
+}
+
+static void end_session(void)
+{
+    session = SESSION_NONE;
+
+#if SCENE_HANDLER_TRANSITIONS
+    set_transition_clock(NULL);
+#endif
+}
+
+#if SCENE_HANDLER_TRANSITIONS
+static double get_input_clock(void)
+{
+    return input_clock;
+}
+#endif
+
+static void add_frame_time(float frame_time)
+{
+    if (num_frames == frame_capacity)
+    {
+        uint32_t capacity = (frame_capacity == 0) ? INITIAL_RECORDED_FRAMES : frame_capacity * 2;
+        float *resized = realloc(frame_times, capacity * sizeof(float));
+
+        if (resized == NULL)
+        {
+            recording_overflowed = true;
+            return;
+        }
+
+        frame_times = resized;
+        frame_capacity = capacity;
+    }
+
+    frame_times[num_frames++] = frame_time;
+}
+
+static bool write_recording(const char *path)
+{
+    RECORDING_HEADER header = { RECORDING_MAGIC, RECORDING_VERSION, num_frames, num_scene_changes, events.count, 0 };
+
+    if (recording_overflowed || num_frames == 0)
+    {
+        return false;
+    }
+
+    FILE *file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(RECORDING_HEADER), 1, file) == 1;
+
+    written = written && fwrite(frame_times, sizeof(float), num_frames, file) == num_frames;
+    written = written && fwrite(scene_changes, sizeof(RECORDED_SCENE_CHANGE), num_scene_changes, file) == num_scene_changes;
+    written = written && fwrite(events.events, sizeof(AutomationEvent), events.count, file) == events.count;
+
+    return (fclose(file) == 0) && written;
+}
+
+static bool read_recording(const char *path)
+{
+    RECORDING_HEADER header;
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool read = fread(&header, sizeof(RECORDING_HEADER), 1, file) == 1;
+
+    read = read && header.magic == RECORDING_MAGIC && header.version == RECORDING_VERSION;
+    read = read && header.num_frames > 0 && header.num_scene_changes <= MAX_RECORDED_SCENE_CHANGES && header.num_events <= MAX_INPUT_EVENTS;
+
+    if (read)
+    {
+        frame_times = malloc(header.num_frames * sizeof(float));
+        events.events = malloc((header.num_events > 0 ? header.num_events : 1) * sizeof(AutomationEvent));
+        read = (frame_times != NULL) && (events.events != NULL);
+    }
+
+    read = read && fread(frame_times, sizeof(float), header.num_frames, file) == header.num_frames;
+    read = read && fread(scene_changes, sizeof(RECORDED_SCENE_CHANGE), header.num_scene_changes, file) == header.num_scene_changes;
+    read = read && fread(events.events, sizeof(AutomationEvent), header.num_events, file) == header.num_events;
+
+    fclose(file);
+
+    for (uint32_t change = 0; read && change < header.num_scene_changes; change++)
+    {
+        read = scene_changes[change].change >= SCENE_CHANGE_SET && scene_changes[change].change <= SCENE_CHANGE_GO_TO;
+    }
+
+    if (read)
+    {
+        num_frames = header.num_frames;
+        frame_capacity = header.num_frames;
+        num_scene_changes = header.num_scene_changes;
+        events.capacity = header.num_events;
+        events.count = header.num_events;
+    }
+
+    return read;
+}
+
+static void release_recording(void)
+{
+    free(frame_times);
+    free(events.events);
+
+    frame_times = NULL;
+    num_frames = 0;
+    frame_capacity = 0;
+    num_scene_changes = 0;
+    events = (AutomationEventList){ 0 };
+    recording_overflowed = false;
+}
+
+#endif
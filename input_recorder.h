@@ -0,0 +1,41 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <stdbool.h>
+
+#include "scene_handler_config.h"
+
+//  Records the input events, frame clock and scene changes of a session so it can be replayed frame for frame
+//  Frames are counted by run_scene(), which should be called once per EndDrawing()
+typedef enum
+{
+    SCENE_CHANGE_SET = 0,
+    SCENE_CHANGE_NEXT,
+    SCENE_CHANGE_GO_TO
+} SCENE_CHANGE;
+
+#if SCENE_HANDLER_INSTRUMENTATION
+bool start_input_recording(void);
+bool stop_input_recording(const char *path);
+bool is_input_recording_active(void);
+
+//  Scene changes and the transition clock come from the recording while it runs, the scenes' own changes are ignored
+//  Scenes must step on get_scene_frame_time() rather than GetFrameTime() to replay the frames they recorded
+//  report_path gets a CSV row per frame of timing and memory, it can be NULL
+//  Start before the first scene is set, which the recording does, and call run_scene() until the replay is no longer active
+//  A hidden window (FLAG_WINDOW_HIDDEN) is enough
+bool start_input_replay(const char *path, const char *report_path);
+void stop_input_replay(void);
+bool is_input_replay_active(void);
+
+//  For the scene handler
+bool is_input_session_active(void);
+bool record_scene_change(SCENE_CHANGE change, int scene_pos);
+bool take_replayed_scene_change(SCENE_CHANGE *change, int *scene_pos);
+void begin_input_frame(int scene_pos);
+void step_input_frame(void);
+float get_input_frame_time(void);
+void end_input_frame(int scene_pos);
+#endif
+
+#endif
@@ -0,0 +1,217 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//  Compares two replay reports from start_input_replay() and fails when the second regressed
+//  Exits 0 when within tolerance, 1 on a timing or memory regression, 2 when the replays diverged and 3 when a report can't be read
+#define DEFAULT_TOLERANCE_PERCENT 10.0
+#define REPORT_PERCENTILE 0.95
+#define MAX_REPORT_LINE_LEN 256
+#define INITIAL_REPORT_FRAMES 1024
+
+typedef struct
+{
+    double frame_ms;
+    int scene_pos;
+    int transition;
+    int quality;
+} REPORT_FRAME;
+
+typedef struct
+{
+    REPORT_FRAME *frames;
+    int num_frames;
+    int capacity;
+    size_t high_water_bytes;
+} REPORT;
+
+static bool read_report(const char *path, REPORT *report);
+static void release_report(REPORT *report);
+static double get_mean(const REPORT *report);
+static double get_percentile(const REPORT *report, double percentile);
+static int compare_doubles(const void *first, const void *second);
+static bool has_diverged(const REPORT *base, const REPORT *test);
+
+
+int main(int argc, char **argv)
+{
+    REPORT base = { 0 };
+    REPORT test = { 0 };
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s base.csv new.csv [tolerance_percent]\n", argv[0]);
+        return 3;
+    }
+
+    double tolerance = 1.0 + (((argc > 3) ? atof(argv[3]) : DEFAULT_TOLERANCE_PERCENT) / 100.0);
+
+    for (int arg = 1; arg <= 2; arg++)
+    {
+        if (read_report(argv[arg], (arg == 1) ? &base : &test) == false)
+        {
+            fprintf(stderr, "can't read %s\n", argv[arg]);
+            release_report(&base);
+            release_report(&test);
+            return 3;
+        }
+    }
+
+    double base_mean = get_mean(&base);
+    double test_mean = get_mean(&test);
+    double base_percentile = get_percentile(&base, REPORT_PERCENTILE);
+    double test_percentile = get_percentile(&test, REPORT_PERCENTILE);
+
+    printf("%-6s %8s %10s %10s %16s\n", "", "frames", "mean ms", "p95 ms", "high water");
+    printf("%-6s %8d %10.3f %10.3f %16zu\n", "base", base.num_frames, base_mean, base_percentile, base.high_water_bytes);
+    printf("%-6s %8d %10.3f %10.3f %16zu\n", "new", test.num_frames, test_mean, test_percentile, test.high_water_bytes);
+
+    int result = 0;
+
+    if (has_diverged(&base, &test))
+    {
+        printf("diverged: the replays did not run the same scenes and transitions at the same quality on the same frames\n");
+        result = 2;
+    }
+    else if (test_mean > base_mean * tolerance || test_percentile > base_percentile * tolerance || (double)test.high_water_bytes > (double)base.high_water_bytes * tolerance)
+    {
+        printf("regressed by more than %.1f%%\n", (tolerance - 1.0) * 100.0);
+        result = 1;
+    }
+
+    release_report(&base);
+    release_report(&test);
+
+    return result;
+}
+
+static bool read_report(const char *path, REPORT *report)
+{
+    char line[MAX_REPORT_LINE_LEN];
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    //  The header
+    bool read = fgets(line, MAX_REPORT_LINE_LEN, file) != NULL;
+
+    while (read && fgets(line, MAX_REPORT_LINE_LEN, file) != NULL)
+    {
+        unsigned int frame;
+        double clock;
+        double frame_ms;
+        int scene_pos;
+        int transition;
+        int quality;
+        size_t live_bytes;
+        size_t high_water_bytes;
+
+        if (sscanf(line, "%u,%lf,%lf,%d,%d,%d,%zu,%zu", &frame, &clock, &frame_ms, &scene_pos, &transition, &quality, &live_bytes, &high_water_bytes) != 8)
+        {
+            read = false;
+            break;
+        }
+
+        if (report->num_frames == report->capacity)
+        {
+            int capacity = (report->capacity == 0) ? INITIAL_REPORT_FRAMES : report->capacity * 2;
+            REPORT_FRAME *resized = realloc(report->frames, capacity * sizeof(REPORT_FRAME));
+
+            if (resized == NULL)
+            {
+                read = false;
+                break;
+            }
+
+            report->frames = resized;
+            report->capacity = capacity;
+        }
+
+        report->frames[report->num_frames++] = (REPORT_FRAME){ frame_ms, scene_pos, transition, quality };
+
+        if (high_water_bytes > report->high_water_bytes)
+        {
+            report->high_water_bytes = high_water_bytes;
+        }
+    }
+
+    fclose(file);
+
+    return read && report->num_frames > 0;
+}
+
+static void release_report(REPORT *report)
+{
+    free(report->frames);
+
+    *report = (REPORT){ 0 };
+}
+
+static double get_mean(const REPORT *report)
+{
+    double total = 0.0;
+
+    for (int frame = 0; frame < report->num_frames; frame++)
+    {
+        total += report->frames[frame].frame_ms;
+    }
+
+    return total / (double)report->num_frames;
+}
+
+static double get_percentile(const REPORT *report, double percentile)
+{
+    double *sorted = malloc(report->num_frames * sizeof(double));
+
+    if (sorted == NULL)
+    {
+        return 0.0;
+    }
+
+    for (int frame = 0; frame < report->num_frames; frame++)
+    {
+        sorted[frame] = report->frames[frame].frame_ms;
+    }
+
+    qsort(sorted, report->num_frames, sizeof(double), &compare_doubles);
+
+    double value = sorted[(int)((report->num_frames - 1) * percentile)];
+
+    free(sorted);
+
+    return value;
+}
+
+static int compare_doubles(const void *first, const void *second)
+{
+    double a = *(const double *)first;
+    double b = *(const double *)second;
+
+    return (a > b) - (a < b);
+}
+
+//  Replays of one recording should differ only in how long their frames took
+//  A transition that dropped to a cheaper quality drew different frames, so that counts as diverging too
+static bool has_diverged(const REPORT *base, const REPORT *test)
+{
+    if (base->num_frames != test->num_frames)
+    {
+        return true;
+    }
+
+    for (int frame = 0; frame < base->num_frames; frame++)
+    {
+        const REPORT_FRAME *base_frame = &base->frames[frame];
+        const REPORT_FRAME *test_frame = &test->frames[frame];
+
+        if (base_frame->scene_pos != test_frame->scene_pos || base_frame->transition != test_frame->transition || base_frame->quality != test_frame->quality)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,137 @@
+#include "scene_handler_config.h"
+
+#if SCENE_HANDLER_INSTRUMENTATION
+
+#include <raylib.h>
+
+#include "memory_tracker.h"
+
+#define BYTES_PER_KB 1024.0
+
+static MEMORY_USAGE usage[MEMORY_ALL + 1];
+
+static const char *subsystem_names[MEMORY_ALL + 1] =
+{
+    "snapshots",
+    "textures",
+    "render targets",
+    "scene assets",
+    "capture",
+    "total"
+};
+
+static size_t get_render_target_size(RenderTexture2D target);
+static void add_bytes(MEMORY_USAGE *subsystem_usage, size_t bytes);
+static void remove_bytes(MEMORY_USAGE *subsystem_usage, size_t bytes);
+
+
+void track_memory_alloc(MEMORY_SUBSYSTEM subsystem, size_t bytes)
+{
+    if (subsystem >= MEMORY_ALL)
+    {
+        return;
+    }
+
+    add_bytes(&usage[subsystem], bytes);
+    add_bytes(&usage[MEMORY_ALL], bytes);
+}
+
+void track_memory_free(MEMORY_SUBSYSTEM subsystem, size_t bytes)
+{
+    if (subsystem >= MEMORY_ALL)
+    {
+        return;
+    }
+
+    remove_bytes(&usage[subsystem], bytes);
+    remove_bytes(&usage[MEMORY_ALL], bytes);
+}
+
+RenderTexture2D load_render_target(int width, int height)
+{
+    RenderTexture2D target = LoadRenderTexture(width, height);
+
+    if (target.id > 0)
+    {
+        track_memory_alloc(MEMORY_RENDER_TARGETS, get_render_target_size(target));
+    }
+
+    return target;
+}
+
+void unload_render_target(RenderTexture2D *target)
+{
+    if (target->id > 0)
+    {
+        track_memory_free(MEMORY_RENDER_TARGETS, get_render_target_size(*target));
+        UnloadRenderTexture(*target);
+    }
+
+    *target = (RenderTexture2D){ 0 };
+}
+
+MEMORY_USAGE get_memory_usage(MEMORY_SUBSYSTEM subsystem)
+{
+    if (subsystem > MEMORY_ALL)
+    {
+        return (MEMORY_USAGE){ 0 };
+    }
+
+    return usage[subsystem];
+}
+
+void reset_memory_high_water(void)
+{
+    for (int subsystem = 0; subsystem <= MEMORY_ALL; subsystem++)
+    {
+        usage[subsystem].high_water_bytes = usage[subsystem].live_bytes;
+    }
+}
+
+const char *get_memory_subsystem_name(MEMORY_SUBSYSTEM subsystem)
+{
+    if (subsystem > MEMORY_ALL)
+    {
+        return "unknown";
+    }
+
+    return subsystem_names[subsystem];
+}
+
+void log_memory_usage(void)
+{
+    for (int subsystem = 0; subsystem <= MEMORY_ALL; subsystem++)
+    {
+        TraceLog(LOG_INFO, "MEMORY: %-14s live %10.1f KB  high water %10.1f KB  allocations %d",
+            subsystem_names[subsystem],
+            (double)usage[subsystem].live_bytes / BYTES_PER_KB,
+            (double)usage[subsystem].high_water_bytes / BYTES_PER_KB,
+            usage[subsystem].live_allocations);
+    }
+}
+
+//  Colour attachment plus the 24 bit depth renderbuffer, which drivers store in 32 bits
+static size_t get_render_target_size(RenderTexture2D target)
+{
+    return (size_t)GetPixelDataSize(target.texture.width, target.texture.height, target.texture.format) + ((size_t)target.texture.width * target.texture.height * 4);
+}
+
+static void add_bytes(MEMORY_USAGE *subsystem_usage, size_t bytes)
+{
+    subsystem_usage->live_bytes += bytes;
+    subsystem_usage->live_allocations++;
+
+    if (subsystem_usage->live_bytes > subsystem_usage->high_water_bytes)
+    {
+        subsystem_usage->high_water_bytes = subsystem_usage->live_bytes;
+    }
+}
+
+//  Clamped, so a mismatched free shows up as a count rather than wrapping around
+static void remove_bytes(MEMORY_USAGE *subsystem_usage, size_t bytes)
+{
+    subsystem_usage->live_bytes = (bytes > subsystem_usage->live_bytes) ? 0 : subsystem_usage->live_bytes - bytes;
+    subsystem_usage->live_allocations--;
+}
+
+#endif
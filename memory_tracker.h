@@ -0,0 +1,49 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "scene_handler_config.h"
+
+typedef enum
+{
+    MEMORY_SNAPSHOTS = 0,
+    MEMORY_TEXTURES,
+    MEMORY_RENDER_TARGETS,
+    MEMORY_SCENE_ASSETS,
+    MEMORY_CAPTURE,
+    MEMORY_ALL
+} MEMORY_SUBSYSTEM;
+
+typedef struct
+{
+    size_t live_bytes;
+    size_t high_water_bytes;
+    int live_allocations;
+} MEMORY_USAGE;
+
+#if SCENE_HANDLER_INSTRUMENTATION
+#include <raylib.h>
+
+void track_memory_alloc(MEMORY_SUBSYSTEM subsystem, size_t bytes);
+void track_memory_free(MEMORY_SUBSYSTEM subsystem, size_t bytes);
+
+//  Render targets are loaded and unloaded through these, so they are counted the same wherever they are used
+RenderTexture2D load_render_target(int width, int height);
+void unload_render_target(RenderTexture2D *target);
+
+//  MEMORY_ALL gives the totals, with the high water mark of the combined live bytes
+MEMORY_USAGE get_memory_usage(MEMORY_SUBSYSTEM subsystem);
+void reset_memory_high_water(void);
+const char *get_memory_subsystem_name(MEMORY_SUBSYSTEM subsystem);
+void log_memory_usage(void);
+#else
+//  The arguments are only looked at by sizeof, so callers pay nothing for the sizes they work out
+#define track_memory_alloc(subsystem, bytes) ((void)sizeof(subsystem), (void)sizeof(bytes))
+#define track_memory_free(subsystem, bytes) ((void)sizeof(subsystem), (void)sizeof(bytes))
+#define load_render_target(width, height) LoadRenderTexture(width, height)
+#define unload_render_target(target) (UnloadRenderTexture(*(target)), *(target) = (RenderTexture2D){ 0 })
+#endif
+
+#endif
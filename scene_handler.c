@@ -1,47 +1,203 @@
+//  For ftruncate() and the rest of the POSIX file mapping calls under strict C
+#define _POSIX_C_SOURCE 200809L
+
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "scene_handler.h"
+#include "memory_tracker.h"
+#include "input_recorder.h"
+
+#if SCENE_HANDLER_ASSET_CACHE || SCENE_HANDLER_INSTRUMENTATION
+#include <raylib.h>
+#endif
+#if SCENE_HANDLER_ASSET_CACHE
+#include <rlgl.h>
+#endif
+
+#if SCENE_HANDLER_SNAPSHOTS
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #define RETURN_IF_FALSE(function)  if (function() == false) { return false; }
 
 #define MAX_SCENE_NAME_LEN 50
 #define MAX_SCENE_ENTRIES 20
+#define MAX_SCENE_EDGES 64
+#define MAX_QUEUED_SCENE_CHANGES 8
+#define MAX_SCENE_LAYERS 4
+
+//  Constants from OpenGL
+#define GL_ONE 1
+#define GL_SRC_ALPHA 0x0302
+#define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_FUNC_ADD 0x8006
+
+#define SNAPSHOT_MAGIC 0x53434E53u
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGNMENT 16
+#define MAX_SNAPSHOT_PATH_LEN 256
 
 static int num_scenes = 0;
 static int current_scene_pos = NO_SCENE;
 
+#if SCENE_HANDLER_TRANSITIONS
+//  NO_SCENE in the queue means whichever scene next_scene() would pick when it is taken
+static int queued_scene_changes[MAX_QUEUED_SCENE_CHANGES];
+static int num_queued_scene_changes = 0;
+#endif
+
+#if SCENE_HANDLER_ASSET_CACHE
+typedef enum
+{
+    WARM_NONE = 0,
+    WARM_WARMING,
+    WARM_READY
+} WARM_STATE;
+
+typedef struct
+{
+    void (*render_method)(void);
+    bool cached;
+    bool dirty;
+    RenderTexture2D target;
+} SCENE_LAYER;
+#endif
+
 typedef struct
 {
     char name[MAX_SCENE_NAME_LEN];
     bool (*init_method)(void);
-    void (*render_method)(void);
     bool (*run_method)(void);
     void (*end_method)(void);
+#if SCENE_HANDLER_TRANSITIONS
+    void (*render_method)(void);
     TRANSITION_TYPE transition_type;
+    TRANSITION_PARAMS transition_params;
+#endif
+#if SCENE_HANDLER_INSTRUMENTATION
+    size_t asset_bytes;
+#endif
+#if SCENE_HANDLER_ASSET_CACHE
+    bool (*warm_method)(void);
+    void (*cancel_method)(void);
+    size_t warm_bytes;
+    WARM_STATE warm_state;
+    SCENE_LAYER layers[MAX_SCENE_LAYERS];
+    int num_layers;
+#endif
+#if SCENE_HANDLER_SNAPSHOTS
+    size_t (*serialize_method)(void *buffer, size_t size);
+    bool (*restore_method)(const void *buffer, size_t size);
+    //  Its state came back from a snapshot, which stands in for the next init
+    bool restored;
+#endif
 } SCENE_ENTRY;
 
+#if SCENE_HANDLER_SNAPSHOTS
+//  Fixed width fields and offsets from the start of the file, so the mapping can live at any address
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layout_hash;
+    int32_t current_scene_pos;
+    uint32_t num_records;
+    uint32_t reserved;
+    uint64_t file_size;
+} SNAPSHOT_HEADER;
+
+typedef struct
+{
+    char name[MAX_SCENE_NAME_LEN];
+    uint64_t offset;
+    uint64_t size;
+} SNAPSHOT_RECORD;
+#endif
+
+typedef struct
+{
+    int from_pos;
+    int to_pos;
+    float weight;
+    bool (*condition)(void);
+} SCENE_EDGE;
+
 static SCENE_ENTRY scene_entries[MAX_SCENE_ENTRIES];
+static SCENE_EDGE scene_edges[MAX_SCENE_EDGES];
+static int num_scene_edges = 0;
 
+#if SCENE_HANDLER_ASSET_CACHE
+static size_t warm_budget = 0;
+static int num_warmups = 0;
+//  Scenes warming or warmed, which have to be checked each frame in case they are no longer likely
+static int num_warm_scenes = 0;
+#endif
 
+#if SCENE_HANDLER_SNAPSHOTS
+static void *snapshot_mapping = NULL;
+static size_t snapshot_mapping_size = 0;
+#endif
+
+
+static bool run_current_scene(void);
+#if SCENE_HANDLER_INSTRUMENTATION
+static bool run_recorded_scene(void);
+static bool apply_scene_change(SCENE_CHANGE change, int scene_pos);
+#endif
+static bool set_current_scene(int scene_pos);
+static bool change_scene(int scene_pos);
+static int get_next_scene_pos(void);
+static bool is_edge_reachable(const SCENE_EDGE *edge);
+#if SCENE_HANDLER_ASSET_CACHE
+static bool is_likely_successor(int scene_pos);
+static void update_scene_warmups(void);
+static void cancel_scene_warmup(int scene_pos);
+static void update_scene_layers(void);
+static void composite_scene_layers(void);
+#if SCENE_HANDLER_TRANSITIONS
+static void render_layered_end_screen(void);
+#endif
+static void release_scene_layers(int scene_pos);
+static void release_scene_layer(SCENE_LAYER *scene_layer);
+#endif
+#if SCENE_HANDLER_SNAPSHOTS
+static uint32_t get_snapshot_layout_hash(void);
+static size_t align_snapshot_size(size_t size);
+static bool is_snapshot_valid(const void *mapping, size_t mapping_size);
+#endif
 static bool init_scene(void);
 static void end_scene(void);
 
 
+//  NO_SCENE when there are too many scenes, or the name is too long to keep whole and would never be found
+#if SCENE_HANDLER_TRANSITIONS
 int add_scene(const char *scene_name, bool (*init_method)(void), void (*render_method)(void), bool (*run_method)(void), void (*end_method)(void), TRANSITION_TYPE transition_type)
+#else
+int add_scene(const char *scene_name, bool (*init_method)(void), bool (*run_method)(void), void (*end_method)(void))
+#endif
 {
     int scene_pos = NO_SCENE;
 
-    if (num_scenes < MAX_SCENE_ENTRIES)
+    if (num_scenes < MAX_SCENE_ENTRIES && strnlen(scene_name, MAX_SCENE_NAME_LEN) < MAX_SCENE_NAME_LEN)
     {
-        SCENE_ENTRY scene_entry;
+        //  Whatever the enabled features add starts out zeroed, which is off for all of them
+        SCENE_ENTRY scene_entry = { 0 };
 
-        strncpy(scene_entry.name, scene_name, MAX_SCENE_NAME_LEN);
+        strcpy(scene_entry.name, scene_name);
         scene_entry.init_method = init_method;
-        scene_entry.render_method = render_method;
         scene_entry.run_method = run_method;
         scene_entry.end_method = end_method;
+#if SCENE_HANDLER_TRANSITIONS
+        scene_entry.render_method = render_method;
         scene_entry.transition_type = transition_type;
+        scene_entry.transition_params = get_default_transition_params();
+#endif
 
         scene_entries[num_scenes] = scene_entry;
         scene_pos = num_scenes++;
@@ -50,6 +206,21 @@ int add_scene(const char *scene_name, bool (*init_method)(void), void (*render_m
     return scene_pos;
 }
 
+#if SCENE_HANDLER_TRANSITIONS
+//  The transition is the one played when leaving the scene
+bool set_scene_transition_params(int scene_pos, TRANSITION_PARAMS params)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return false;
+    }
+
+    scene_entries[scene_pos].transition_params = params;
+
+    return true;
+}
+#endif
+
 bool set_scene(int scene_pos)
 {
     if (num_scenes == 0)
@@ -57,9 +228,15 @@ bool set_scene(int scene_pos)
         return false;
     }
 
-    current_scene_pos = scene_pos;    
+#if SCENE_HANDLER_INSTRUMENTATION
+    //  Replays make the recorded scene changes themselves
+    if (record_scene_change(SCENE_CHANGE_SET, scene_pos) == false)
+    {
+        return true;
+    }
+#endif
 
-    return init_scene();
+    return set_current_scene(scene_pos);
 }
 
 bool first_scene(void)
@@ -69,59 +246,406 @@ bool first_scene(void)
         return false;
     }
 
-    current_scene_pos = 0;
+#if SCENE_HANDLER_INSTRUMENTATION
+    if (record_scene_change(SCENE_CHANGE_SET, 0) == false)
+    {
+        return true;
+    }
+#endif
 
-    return init_scene();
+    return set_current_scene(0);
 }
 
-//  This can be called instead of first_scene(), which is just for syntactical nicety
-bool next_scene(void)
+#if SCENE_HANDLER_SNAPSHOTS
+//  serialize_method is first called with a NULL buffer to size the state, then to write it
+bool set_scene_snapshot(int scene_pos, size_t (*serialize_method)(void *buffer, size_t size), bool (*restore_method)(const void *buffer, size_t size))
 {
-    TRANSITION_TYPE transition_type = TRANSITION_NONE;
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return false;
+    }
 
-    if (num_scenes == 0)
+    scene_entries[scene_pos].serialize_method = serialize_method;
+    scene_entries[scene_pos].restore_method = restore_method;
+
+    return true;
+}
+
+//  Scenes serialize straight into the mapped file, which is written alongside and renamed into place
+bool save_scene_snapshot(const char *path)
+{
+    char temp_path[MAX_SNAPSHOT_PATH_LEN];
+    SNAPSHOT_HEADER header = { SNAPSHOT_MAGIC, SNAPSHOT_VERSION, get_snapshot_layout_hash(), current_scene_pos, 0, 0, 0 };
+    size_t state_sizes[MAX_SCENE_ENTRIES] = { 0 };
+    size_t file_size;
+
+    for (int pos = 0; pos < num_scenes; pos++)
+    {
+        if (scene_entries[pos].serialize_method != NULL)
+        {
+            state_sizes[pos] = scene_entries[pos].serialize_method(NULL, 0);
+            header.num_records++;
+        }
+    }
+
+    file_size = align_snapshot_size(sizeof(SNAPSHOT_HEADER) + (header.num_records * sizeof(SNAPSHOT_RECORD)));
+
+    for (int pos = 0; pos < num_scenes; pos++)
+    {
+        file_size += align_snapshot_size(state_sizes[pos]);
+    }
+
+    header.file_size = file_size;
+
+    if (snprintf(temp_path, MAX_SNAPSHOT_PATH_LEN, "%s.tmp", path) >= MAX_SNAPSHOT_PATH_LEN)
     {
         return false;
     }
 
-    if (current_scene_pos != NO_SCENE)
+    int file = open(temp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (file < 0)
     {
-        if (scene_entries[current_scene_pos].transition_type != TRANSITION_NONE)
+        return false;
+    }
+
+    if (ftruncate(file, (off_t)file_size) != 0)
+    {
+        close(file);
+        return false;
+    }
+
+    unsigned char *mapping = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+
+    close(file);
+
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    SNAPSHOT_RECORD *records = (SNAPSHOT_RECORD *)(mapping + sizeof(SNAPSHOT_HEADER));
+    size_t offset = align_snapshot_size(sizeof(SNAPSHOT_HEADER) + (header.num_records * sizeof(SNAPSHOT_RECORD)));
+    int record = 0;
+    bool saved = true;
+
+    memcpy(mapping, &header, sizeof(SNAPSHOT_HEADER));
+
+    for (int pos = 0; pos < num_scenes; pos++)
+    {
+        if (scene_entries[pos].serialize_method == NULL)
         {
-            transition_type = scene_entries[current_scene_pos].transition_type;
-            set_transition_start_screen();
+            continue;
         }
 
-        end_scene();
+        //  Names are always terminated and padded with zeros, as add_scene() refuses any too long to be
+        memcpy(records[record].name, scene_entries[pos].name, MAX_SCENE_NAME_LEN);
+        records[record].offset = offset;
+        records[record].size = scene_entries[pos].serialize_method(mapping + offset, state_sizes[pos]);
+
+        if (records[record].size > state_sizes[pos])
+        {
+            saved = false;
+        }
+
+        offset += align_snapshot_size(state_sizes[pos]);
+        record++;
+    }
+
+    saved = saved && (msync(mapping, file_size, MS_SYNC) == 0);
+    munmap(mapping, file_size);
+
+    if (saved == false || rename(temp_path, path) != 0)
+    {
+        unlink(temp_path);
+        return false;
     }
 
-    if (++current_scene_pos > num_scenes)
+    return true;
+}
+
+//  Used instead of first_scene(), each scene whose state came back skips its init method the next time it is entered
+bool restore_scene_snapshot(const char *path)
+{
+    struct stat file_stat;
+
+    close_scene_snapshot();
+
+    int file = open(path, O_RDONLY);
+
+    if (file < 0)
     {
-        current_scene_pos = 0;
+        return false;
     }
 
-    bool init = init_scene();
+    if (fstat(file, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(SNAPSHOT_HEADER))
+    {
+        close(file);
+        return false;
+    }
 
-    if (transition_type != TRANSITION_NONE)
+    //  Private, so scenes can point into and even modify their state without touching the file
+    void *mapping = mmap(NULL, (size_t)file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+    close(file);
+
+    if (mapping == MAP_FAILED)
     {
-        set_transition_end_screen(scene_entries[current_scene_pos].render_method);
-        start_transition(transition_type);
+        return false;
     }
 
-    return init;
+    if (is_snapshot_valid(mapping, (size_t)file_stat.st_size) == false)
+    {
+        munmap(mapping, (size_t)file_stat.st_size);
+        return false;
+    }
+
+    const SNAPSHOT_HEADER *header = (const SNAPSHOT_HEADER *)mapping;
+    const SNAPSHOT_RECORD *records = (const SNAPSHOT_RECORD *)((const unsigned char *)mapping + sizeof(SNAPSHOT_HEADER));
+
+    snapshot_mapping = mapping;
+    snapshot_mapping_size = (size_t)file_stat.st_size;
+
+    for (int pos = 0; pos < num_scenes; pos++)
+    {
+        scene_entries[pos].restored = false;
+    }
+
+    for (uint32_t record = 0; record < header->num_records; record++)
+    {
+        int pos = find_scene_pos((char *)records[record].name);
+
+        if (pos == NO_SCENE || scene_entries[pos].restore_method == NULL)
+        {
+            continue;
+        }
+
+        scene_entries[pos].restored = scene_entries[pos].restore_method((const unsigned char *)mapping + records[record].offset, (size_t)records[record].size);
+    }
+
+    if (header->current_scene_pos == NO_SCENE)
+    {
+        return true;
+    }
+
+    current_scene_pos = header->current_scene_pos;
+
+    return init_scene();
+}
+
+//  Restored scenes may hold pointers into the snapshot, so only call this once they are done with it
+void close_scene_snapshot(void)
+{
+    if (snapshot_mapping != NULL)
+    {
+        munmap(snapshot_mapping, snapshot_mapping_size);
+        snapshot_mapping = NULL;
+        snapshot_mapping_size = 0;
+    }
+}
+#endif
+
+//  Edges leave from_pos for to_pos, a NULL condition means the edge is always available
+bool add_scene_edge(int from_pos, int to_pos, float weight, bool (*condition)(void))
+{
+    if (num_scene_edges >= MAX_SCENE_EDGES || from_pos < 0 || from_pos >= num_scenes || to_pos < 0 || to_pos >= num_scenes || weight <= 0.0f)
+    {
+        return false;
+    }
+
+    scene_edges[num_scene_edges++] = (SCENE_EDGE){ from_pos, to_pos, weight, condition };
+
+    return true;
+}
+
+#if SCENE_HANDLER_ASSET_CACHE
+//  warm_method is called once a frame until it returns true, cancel_method releases what it loaded
+bool set_scene_warmup(int scene_pos, bool (*warm_method)(void), void (*cancel_method)(void), size_t warm_bytes)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return false;
+    }
+
+    num_warmups += (warm_method != NULL) - (scene_entries[scene_pos].warm_method != NULL);
+
+    scene_entries[scene_pos].warm_method = warm_method;
+    scene_entries[scene_pos].cancel_method = cancel_method;
+    scene_entries[scene_pos].warm_bytes = warm_bytes;
+
+    return true;
+}
+
+//  Layers are drawn in the order added, cached layers are only re-rendered once invalidated
+int add_scene_layer(int scene_pos, void (*render_method)(void), bool cached)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes || scene_entries[scene_pos].num_layers >= MAX_SCENE_LAYERS)
+    {
+        return NO_LAYER;
+    }
+
+    SCENE_ENTRY *scene_entry = &scene_entries[scene_pos];
+
+    scene_entry->layers[scene_entry->num_layers] = (SCENE_LAYER){ render_method, cached, true, (RenderTexture2D){ 0 } };
+
+    return scene_entry->num_layers++;
+}
+
+bool invalidate_scene_layer(int scene_pos, int layer)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes || layer < 0 || layer >= scene_entries[scene_pos].num_layers)
+    {
+        return false;
+    }
+
+    scene_entries[scene_pos].layers[layer].dirty = true;
+
+    return true;
+}
+
+//  Call from the scene's run method between BeginDrawing() and EndDrawing()
+void draw_scene_layers(void)
+{
+    update_scene_layers();
+    composite_scene_layers();
+}
+
+//  A budget of 0 turns warming off
+void set_scene_warm_budget(size_t bytes)
+{
+    warm_budget = bytes;
+}
+#endif
+
+//  This can be called instead of first_scene(), which is just for syntactical nicety
+//  False, staying on the current scene, when it has edges and none of them are available
+bool next_scene(void)
+{
+    if (num_scenes == 0)
+    {
+        return false;
+    }
+
+#if SCENE_HANDLER_INSTRUMENTATION
+    if (record_scene_change(SCENE_CHANGE_NEXT, NO_SCENE) == false)
+    {
+        return true;
+    }
+#endif
+
+    return change_scene(NO_SCENE);
+}
+
+//  As next_scene(), including its transition, but to any scene
+bool go_to_scene(int scene_pos)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return false;
+    }
+
+#if SCENE_HANDLER_INSTRUMENTATION
+    if (record_scene_change(SCENE_CHANGE_GO_TO, scene_pos) == false)
+    {
+        return true;
+    }
+#endif
+
+    return change_scene(scene_pos);
 }
 
 bool run_scene(void)
 {
+#if SCENE_HANDLER_INSTRUMENTATION
+    if (is_input_session_active())
+    {
+        return run_recorded_scene();
+    }
+#endif
+
+    return run_current_scene();
+}
+
+static bool run_current_scene(void)
+{
+#if SCENE_HANDLER_TRANSITIONS
     if (is_transition_active())
     {
         run_transition();
-        return true;
+
+        bool running = true;
+
+        //  Changes into scenes without a transition finish at once, so the queue is drained until one starts
+        while (is_transition_active() == false && num_queued_scene_changes > 0)
+        {
+            int scene_pos = queued_scene_changes[0];
+
+            num_queued_scene_changes--;
+            memmove(&queued_scene_changes[0], &queued_scene_changes[1], num_queued_scene_changes * sizeof(int));
+
+            running = change_scene(scene_pos) && running;
+        }
+
+        return running;
     }
+#endif
+
+#if SCENE_HANDLER_ASSET_CACHE
+    update_scene_warmups();
+#endif
 
     return scene_entries[current_scene_pos].run_method();
 }
 
+#if SCENE_HANDLER_INSTRUMENTATION
+//  Replayed changes are made before the clock steps, so they start their transitions at the recorded time
+static bool run_recorded_scene(void)
+{
+    SCENE_CHANGE change;
+    int scene_pos;
+    bool running = true;
+
+    begin_input_frame(current_scene_pos);
+
+    while (take_replayed_scene_change(&change, &scene_pos))
+    {
+        running = apply_scene_change(change, scene_pos) && running;
+    }
+
+    step_input_frame();
+
+    if (current_scene_pos != NO_SCENE)
+    {
+        running = run_current_scene() && running;
+    }
+
+    end_input_frame(current_scene_pos);
+
+    return running;
+}
+
+//  As the public functions would, but past the recorder
+static bool apply_scene_change(SCENE_CHANGE change, int scene_pos)
+{
+    if (change == SCENE_CHANGE_NEXT)
+    {
+        return change_scene(NO_SCENE);
+    }
+
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return false;
+    }
+
+    if (change == SCENE_CHANGE_GO_TO)
+    {
+        return change_scene(scene_pos);
+    }
+
+    return set_current_scene(scene_pos);
+}
+#endif
+
 int find_scene_pos(char *scene_name)
 {
     int scene_pos = NO_SCENE;
@@ -138,8 +662,476 @@ int find_scene_pos(char *scene_name)
     return scene_pos;
 }
 
+#if SCENE_HANDLER_INSTRUMENTATION
+float get_scene_frame_time(void)
+{
+    if (is_input_replay_active())
+    {
+        return get_input_frame_time();
+    }
+
+    return GetFrameTime();
+}
+
+//  Replaces any previous figure for the scene, so scenes can report as their assets change
+bool report_scene_memory(int scene_pos, size_t bytes)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return false;
+    }
+
+    if (scene_entries[scene_pos].asset_bytes > 0)
+    {
+        track_memory_free(MEMORY_SCENE_ASSETS, scene_entries[scene_pos].asset_bytes);
+    }
+
+    if (bytes > 0)
+    {
+        track_memory_alloc(MEMORY_SCENE_ASSETS, bytes);
+    }
+
+    scene_entries[scene_pos].asset_bytes = bytes;
+
+    return true;
+}
+
+size_t get_scene_memory(int scene_pos)
+{
+    if (scene_pos < 0 || scene_pos >= num_scenes)
+    {
+        return 0;
+    }
+
+    return scene_entries[scene_pos].asset_bytes;
+}
+#endif
+
+//  Setting a scene outright drops the changes queued behind the running transition
+static bool set_current_scene(int scene_pos)
+{
+#if SCENE_HANDLER_TRANSITIONS
+    num_queued_scene_changes = 0;
+#endif
+
+    current_scene_pos = scene_pos;
+
+    return init_scene();
+}
+
+static bool change_scene(int scene_pos)
+{
+#if SCENE_HANDLER_TRANSITIONS
+    TRANSITION_TYPE transition_type = TRANSITION_NONE;
+    TRANSITION_PARAMS transition_params;
+
+    if (is_transition_active() && get_transition_interrupt() == TRANSITION_INTERRUPT_QUEUE)
+    {
+        if (num_queued_scene_changes >= MAX_QUEUED_SCENE_CHANGES)
+        {
+            return false;
+        }
+
+        //  Picked up by run_scene() once the running transition completes
+        queued_scene_changes[num_queued_scene_changes++] = scene_pos;
+        return true;
+    }
+#endif
+
+    if (scene_pos == NO_SCENE)
+    {
+        scene_pos = get_next_scene_pos();
+
+        //  Stays put until one of the scene's edges is available
+        if (scene_pos == NO_SCENE)
+        {
+            return false;
+        }
+    }
+
+    if (current_scene_pos != NO_SCENE)
+    {
+#if SCENE_HANDLER_TRANSITIONS
+        if (scene_entries[current_scene_pos].transition_type != TRANSITION_NONE)
+        {
+            transition_type = scene_entries[current_scene_pos].transition_type;
+            transition_params = scene_entries[current_scene_pos].transition_params;
+            set_transition_start_screen();
+        }
+        else if (is_transition_active())
+        {
+            stop_transition();
+        }
+#endif
+
+        end_scene();
+    }
+
+    current_scene_pos = scene_pos;
+
+    bool init = init_scene();
+
+#if SCENE_HANDLER_TRANSITIONS
+    if (transition_type != TRANSITION_NONE)
+    {
+        void (*end_screen)(void) = scene_entries[current_scene_pos].render_method;
+
+#if SCENE_HANDLER_ASSET_CACHE
+        if (scene_entries[current_scene_pos].num_layers > 0)
+        {
+            //  Render targets can't nest, so the cached layers are brought up to date first
+            update_scene_layers();
+            end_screen = &render_layered_end_screen;
+        }
+#endif
+
+        set_transition_end_screen(end_screen);
+        start_transition_with_params(transition_type, transition_params);
+    }
+#endif
+
+    return init;
+}
+
+//  The heaviest available edge, or the following scene in the order added for a scene without edges
+//  NO_SCENE when the scene has edges but none are available, as is_likely_successor() sees it
+static int get_next_scene_pos(void)
+{
+    const SCENE_EDGE *best_edge = NULL;
+    bool has_edges = false;
+
+    for (int edge = 0; edge < num_scene_edges; edge++)
+    {
+        has_edges = has_edges || scene_edges[edge].from_pos == current_scene_pos;
+
+        if (is_edge_reachable(&scene_edges[edge]) && (best_edge == NULL || scene_edges[edge].weight > best_edge->weight))
+        {
+            best_edge = &scene_edges[edge];
+        }
+    }
+
+    if (best_edge != NULL)
+    {
+        return best_edge->to_pos;
+    }
+
+    if (has_edges)
+    {
+        return NO_SCENE;
+    }
+
+    return (current_scene_pos + 1 >= num_scenes) ? 0 : current_scene_pos + 1;
+}
+
+static bool is_edge_reachable(const SCENE_EDGE *edge)
+{
+    return edge->from_pos == current_scene_pos && (edge->condition == NULL || edge->condition());
+}
+
+#if SCENE_HANDLER_ASSET_CACHE
+static bool is_likely_successor(int scene_pos)
+{
+    bool has_edges = false;
+
+    for (int edge = 0; edge < num_scene_edges; edge++)
+    {
+        if (scene_edges[edge].from_pos != current_scene_pos)
+        {
+            continue;
+        }
+
+        has_edges = true;
+
+        if (scene_edges[edge].to_pos == scene_pos && is_edge_reachable(&scene_edges[edge]))
+        {
+            return true;
+        }
+    }
+
+    return has_edges == false && scene_pos == get_next_scene_pos();
+}
+
+//  Cancels warm-ups that can no longer be reached, then gives one step to the heaviest successor that fits the budget
+static void update_scene_warmups(void)
+{
+    size_t warm_total = 0;
+    int best_pos = NO_SCENE;
+    float best_weight = 0.0f;
+
+    //  Runs every frame, so it returns straight away when nothing is warm and nothing could be warmed
+    if (num_warm_scenes == 0 && (num_warmups == 0 || warm_budget == 0))
+    {
+        return;
+    }
+
+    for (int pos = 0; pos < num_scenes; pos++)
+    {
+        if (scene_entries[pos].warm_state == WARM_NONE)
+        {
+            continue;
+        }
+
+        if (is_likely_successor(pos) == false)
+        {
+            cancel_scene_warmup(pos);
+        }
+        else
+        {
+            warm_total += scene_entries[pos].warm_bytes;
+        }
+    }
+
+    if (warm_budget == 0)
+    {
+        return;
+    }
+
+    for (int edge = 0; edge <= num_scene_edges; edge++)
+    {
+        //  The extra pass stands in for the implicit edge of a scene without any
+        int scene_pos = (edge < num_scene_edges) ? scene_edges[edge].to_pos : get_next_scene_pos();
+        float weight = (edge < num_scene_edges) ? scene_edges[edge].weight : 0.0f;
+
+        //  A scene whose edges are all unavailable has no implicit one
+        if (scene_pos == NO_SCENE)
+        {
+            continue;
+        }
+
+        SCENE_ENTRY *scene_entry = &scene_entries[scene_pos];
+
+        if (scene_entry->warm_method == NULL || scene_entry->warm_state == WARM_READY || scene_pos == current_scene_pos)
+        {
+            continue;
+        }
+
+        if (edge < num_scene_edges && is_edge_reachable(&scene_edges[edge]) == false)
+        {
+            continue;
+        }
+
+        if (edge == num_scene_edges && is_likely_successor(scene_pos) == false)
+        {
+            continue;
+        }
+
+        if (scene_entry->warm_state == WARM_NONE && warm_total + scene_entry->warm_bytes > warm_budget)
+        {
+            continue;
+        }
+
+        if (best_pos == NO_SCENE || weight > best_weight)
+        {
+            best_pos = scene_pos;
+            best_weight = weight;
+        }
+    }
+
+    if (best_pos == NO_SCENE)
+    {
+        return;
+    }
+
+    if (scene_entries[best_pos].warm_state == WARM_NONE)
+    {
+        scene_entries[best_pos].warm_state = WARM_WARMING;
+        num_warm_scenes++;
+#if SCENE_HANDLER_INSTRUMENTATION
+        report_scene_memory(best_pos, scene_entries[best_pos].warm_bytes);
+#endif
+    }
+
+    if (scene_entries[best_pos].warm_method())
+    {
+        scene_entries[best_pos].warm_state = WARM_READY;
+    }
+}
+
+static void cancel_scene_warmup(int scene_pos)
+{
+    if (scene_entries[scene_pos].cancel_method != NULL)
+    {
+        scene_entries[scene_pos].cancel_method();
+    }
+
+    scene_entries[scene_pos].warm_state = WARM_NONE;
+    num_warm_scenes--;
+#if SCENE_HANDLER_INSTRUMENTATION
+    report_scene_memory(scene_pos, 0);
+#endif
+}
+
+static void update_scene_layers(void)
+{
+    SCENE_ENTRY *scene_entry = &scene_entries[current_scene_pos];
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+
+    for (int layer = 0; layer < scene_entry->num_layers; layer++)
+    {
+        SCENE_LAYER *scene_layer = &scene_entry->layers[layer];
+
+        if (scene_layer->cached == false)
+        {
+            continue;
+        }
+
+        if (scene_layer->target.id == 0 || scene_layer->target.texture.width != width || scene_layer->target.texture.height != height)
+        {
+            release_scene_layer(scene_layer);
+
+            scene_layer->target = load_render_target(width, height);
+            scene_layer->dirty = true;
+        }
+
+        //  Alpha is blended separately so the target ends up premultiplied, otherwise it would be applied again
+        //  when the layer is composited and translucent edges would come out darker
+        if (scene_layer->dirty)
+        {
+            BeginTextureMode(scene_layer->target);
+                ClearBackground(BLANK);
+                rlSetBlendFactorsSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_FUNC_ADD, GL_FUNC_ADD);
+                rlSetBlendMode(BLEND_CUSTOM_SEPARATE);
+                scene_layer->render_method();
+                rlSetBlendMode(BLEND_ALPHA);
+            EndTextureMode();
+
+            scene_layer->dirty = false;
+        }
+    }
+}
+
+static void composite_scene_layers(void)
+{
+    SCENE_ENTRY *scene_entry = &scene_entries[current_scene_pos];
+
+    for (int layer = 0; layer < scene_entry->num_layers; layer++)
+    {
+        SCENE_LAYER *scene_layer = &scene_entry->layers[layer];
+
+        if (scene_layer->cached == false)
+        {
+            scene_layer->render_method();
+            continue;
+        }
+
+        // RenderTextures have an opposite Y axis
+        Rectangle rect_source = (Rectangle){ 0, 0, (float)scene_layer->target.texture.width, -(float)scene_layer->target.texture.height };
+
+        rlSetBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(scene_layer->target.texture, rect_source, (Vector2){ 0, 0 }, WHITE);
+        rlSetBlendMode(BLEND_ALPHA);
+    }
+}
+
+#if SCENE_HANDLER_TRANSITIONS
+//  The transition reuses its end screen texture, so the last transition's end screen is cleared away first
+static void render_layered_end_screen(void)
+{
+    ClearBackground(BLACK);
+    composite_scene_layers();
+}
+#endif
+
+static void release_scene_layers(int scene_pos)
+{
+    for (int layer = 0; layer < scene_entries[scene_pos].num_layers; layer++)
+    {
+        release_scene_layer(&scene_entries[scene_pos].layers[layer]);
+        scene_entries[scene_pos].layers[layer].dirty = true;
+    }
+}
+
+static void release_scene_layer(SCENE_LAYER *scene_layer)
+{
+    if (scene_layer->target.id > 0)
+    {
+        unload_render_target(&scene_layer->target);
+    }
+}
+#endif
+
+#if SCENE_HANDLER_SNAPSHOTS
+//  Changes whenever the file layout or the registered scenes do, so a stale snapshot is never restored
+static uint32_t get_snapshot_layout_hash(void)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t layout[] = { SNAPSHOT_VERSION, sizeof(SNAPSHOT_HEADER), sizeof(SNAPSHOT_RECORD), (uint32_t)num_scenes };
+
+    for (size_t pos = 0; pos < sizeof(layout); pos++)
+    {
+        hash = (hash ^ ((const unsigned char *)layout)[pos]) * 16777619u;
+    }
+
+    for (int pos = 0; pos < num_scenes; pos++)
+    {
+        for (const char *name = scene_entries[pos].name; *name != '\0' && name < scene_entries[pos].name + MAX_SCENE_NAME_LEN; name++)
+        {
+            hash = (hash ^ (unsigned char)*name) * 16777619u;
+        }
+
+        hash = (hash ^ (scene_entries[pos].serialize_method != NULL)) * 16777619u;
+    }
+
+    return hash;
+}
+
+static size_t align_snapshot_size(size_t size)
+{
+    return (size + SNAPSHOT_ALIGNMENT - 1) & ~(size_t)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+static bool is_snapshot_valid(const void *mapping, size_t mapping_size)
+{
+    const SNAPSHOT_HEADER *header = (const SNAPSHOT_HEADER *)mapping;
+    const SNAPSHOT_RECORD *records = (const SNAPSHOT_RECORD *)((const unsigned char *)mapping + sizeof(SNAPSHOT_HEADER));
+
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION || header->layout_hash != get_snapshot_layout_hash() || header->file_size != mapping_size)
+    {
+        return false;
+    }
+
+    if (header->current_scene_pos < NO_SCENE || header->current_scene_pos >= num_scenes || header->num_records > MAX_SCENE_ENTRIES)
+    {
+        return false;
+    }
+
+    if (sizeof(SNAPSHOT_HEADER) + (header->num_records * sizeof(SNAPSHOT_RECORD)) > mapping_size)
+    {
+        return false;
+    }
+
+    for (uint32_t record = 0; record < header->num_records; record++)
+    {
+        if (records[record].offset > mapping_size || records[record].size > mapping_size - records[record].offset || records[record].name[MAX_SCENE_NAME_LEN - 1] != '\0')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
 static bool init_scene(void)
 {
+#if SCENE_HANDLER_ASSET_CACHE
+    //  Anything warmed now belongs to the running scene
+    if (scene_entries[current_scene_pos].warm_state != WARM_NONE)
+    {
+        scene_entries[current_scene_pos].warm_state = WARM_NONE;
+        num_warm_scenes--;
+    }
+#endif
+
+#if SCENE_HANDLER_SNAPSHOTS
+    if (scene_entries[current_scene_pos].restored)
+    {
+        scene_entries[current_scene_pos].restored = false;
+        return true;
+    }
+#endif
+
     if (scene_entries[current_scene_pos].init_method == NULL)
     {
         //  Is ok not to have an initialisation function
@@ -156,4 +1148,12 @@ static void end_scene(void)
         //  Is ok not to have an cleanup function
         scene_entries[current_scene_pos].end_method();
     }
+
+#if SCENE_HANDLER_INSTRUMENTATION
+    //  A scene's assets are expected to be released by its cleanup function
+    report_scene_memory(current_scene_pos, 0);
+#endif
+#if SCENE_HANDLER_ASSET_CACHE
+    release_scene_layers(current_scene_pos);
+#endif
 }
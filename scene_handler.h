@@ -1,18 +1,59 @@
 #ifndef SCENE_HANDLER_H
 #define SCENE_HANDLER_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "scene_handler_config.h"
+
+#if SCENE_HANDLER_TRANSITIONS
 #include "transition_handler.h"
+#endif
 
 #define NO_SCENE -1
+#define NO_LAYER -1
 
 
+#if SCENE_HANDLER_TRANSITIONS
 int add_scene(const char *scene_name, bool (*init_method)(void), void (*render_method)(void), bool (*run_method)(void), void (*end_method)(void), TRANSITION_TYPE transition_type);
+bool set_scene_transition_params(int scene_pos, TRANSITION_PARAMS params);
+#else
+int add_scene(const char *scene_name, bool (*init_method)(void), bool (*run_method)(void), void (*end_method)(void));
+#endif
+bool add_scene_edge(int from_pos, int to_pos, float weight, bool (*condition)(void));
+
+#if SCENE_HANDLER_ASSET_CACHE
+bool set_scene_warmup(int scene_pos, bool (*warm_method)(void), void (*cancel_method)(void), size_t warm_bytes);
+void set_scene_warm_budget(size_t bytes);
+
+int add_scene_layer(int scene_pos, void (*render_method)(void), bool cached);
+bool invalidate_scene_layer(int scene_pos, int layer);
+void draw_scene_layers(void);
+#endif
+
+#if SCENE_HANDLER_SNAPSHOTS
+bool set_scene_snapshot(int scene_pos, size_t (*serialize_method)(void *buffer, size_t size), bool (*restore_method)(const void *buffer, size_t size));
+bool save_scene_snapshot(const char *path);
+bool restore_scene_snapshot(const char *path);
+void close_scene_snapshot(void);
+#endif
 
 bool set_scene(int scene_pos);
 bool first_scene(void);
 bool next_scene(void);
+bool go_to_scene(int scene_pos);
 bool run_scene(void);
 
 int find_scene_pos(char *scene_name);
 
+//  Scenes should step on this rather than GetFrameTime(), as it is the recorded frame time while an input replay runs
+#if SCENE_HANDLER_INSTRUMENTATION
+float get_scene_frame_time(void);
+
+bool report_scene_memory(int scene_pos, size_t bytes);
+size_t get_scene_memory(int scene_pos);
+#else
+#define get_scene_frame_time() GetFrameTime()
+#endif
+
 #endif
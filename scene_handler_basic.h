@@ -1,15 +1,13 @@
-#ifndef SCENE_HANDLER_H
-#define SCENE_HANDLER_H
+#ifndef SCENE_HANDLER_BASIC_H
+#define SCENE_HANDLER_BASIC_H
 
-#define NO_SCENE -1
+//  For linking against libscene_handler_basic, which is scene_handler.c built with every feature off
+#define SCENE_HANDLER_TRANSITIONS 0
+#define SCENE_HANDLER_INSTRUMENTATION 0
+#define SCENE_HANDLER_THREADING 0
+#define SCENE_HANDLER_ASSET_CACHE 0
+#define SCENE_HANDLER_SNAPSHOTS 0
 
-int add_scene(const char *scene_name, bool (*init_method)(void), bool (*run_method)(void), void (*end_method)(void));
-
-bool set_scene(int scene_pos);
-bool first_scene();
-bool next_scene();
-bool run_scene();
-
-int find_scene_pos(char *scene_name);
+#include "scene_handler.h"
 
 #endif
@@ -0,0 +1,72 @@
+//  For clock_gettime() under strict C
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "scene_handler.h"
+
+//  Times the per frame cost of run_scene() for whichever configuration it is built against, no window is needed
+#define BENCH_SCENES 8
+#define BENCH_FRAMES 10000000
+#define BENCH_FRAMES_PER_SCENE 1000
+
+static long frames_run = 0;
+
+static bool run_bench_scene(void);
+static double get_seconds(void);
+
+
+int main(int argc, char **argv)
+{
+    long frames = (argc > 1) ? atol(argv[1]) : BENCH_FRAMES;
+    char scene_name[16];
+
+    for (int scene = 0; scene < BENCH_SCENES; scene++)
+    {
+        snprintf(scene_name, sizeof(scene_name), "bench %d", scene);
+
+#if SCENE_HANDLER_TRANSITIONS
+        add_scene(scene_name, NULL, NULL, &run_bench_scene, NULL, TRANSITION_NONE);
+#else
+        add_scene(scene_name, NULL, &run_bench_scene, NULL);
+#endif
+    }
+
+    first_scene();
+
+    double start = get_seconds();
+
+    for (long frame = 0; frame < frames; frame++)
+    {
+        run_scene();
+
+        if (frame % BENCH_FRAMES_PER_SCENE == 0)
+        {
+            next_scene();
+        }
+    }
+
+    double elapsed = get_seconds() - start;
+
+    printf("%ld frames, %.2f ns per run_scene()\n", frames_run, elapsed * 1e9 / (double)frames);
+
+    return 0;
+}
+
+static bool run_bench_scene(void)
+{
+    frames_run++;
+
+    return true;
+}
+
+static double get_seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
@@ -0,0 +1,31 @@
+#ifndef SCENE_HANDLER_CONFIG_H
+#define SCENE_HANDLER_CONFIG_H
+
+//  Every feature is on unless built with -DSCENE_HANDLER_<FEATURE>=0, disabled features are compiled out entirely
+
+//  Transitions between scenes, including queued and interrupted changes and the CPU compositor
+#ifndef SCENE_HANDLER_TRANSITIONS
+#define SCENE_HANDLER_TRANSITIONS 1
+#endif
+
+//  Memory tracking and frame capture
+#ifndef SCENE_HANDLER_INSTRUMENTATION
+#define SCENE_HANDLER_INSTRUMENTATION 1
+#endif
+
+//  The frame capture worker, without it captured frames are written on the main thread
+#ifndef SCENE_HANDLER_THREADING
+#define SCENE_HANDLER_THREADING 1
+#endif
+
+//  Warming likely successors and cached scene layers
+#ifndef SCENE_HANDLER_ASSET_CACHE
+#define SCENE_HANDLER_ASSET_CACHE 1
+#endif
+
+//  Warm-restart snapshots, which need POSIX file mapping
+#ifndef SCENE_HANDLER_SNAPSHOTS
+#define SCENE_HANDLER_SNAPSHOTS 1
+#endif
+
+#endif
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "transition_compositor.h"
+
+//  Checks every supported fade kernel byte for byte against the scalar one, and the slide and circle
+//  compositors against a naive per-pixel reference
+#define TEST_WIDTH 37
+#define TEST_HEIGHT 23
+#define TEST_PIXELS (TEST_WIDTH * TEST_HEIGHT)
+#define BYTES_PER_PIXEL 4
+
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static const char *kernel_names[] = { "auto", "scalar", "sse2", "avx2", "neon" };
+
+//  Lengths either side of the vector widths, so every kernel's tail handling runs
+static const int fade_lengths[] = { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, TEST_PIXELS };
+
+static int failures = 0;
+
+static unsigned char start[TEST_PIXELS * BYTES_PER_PIXEL];
+static unsigned char end[TEST_PIXELS * BYTES_PER_PIXEL];
+static unsigned char expected[TEST_PIXELS * BYTES_PER_PIXEL];
+static unsigned char actual[TEST_PIXELS * BYTES_PER_PIXEL];
+
+static void check_fade_kernels(void);
+static void check_slide(void);
+static void check_circle(void);
+static const unsigned char *get_slide_pixel(int x, int y, int start_x, int end_x);
+
+
+int main(void)
+{
+    srand(1);
+
+    for (int pos = 0; pos < TEST_PIXELS * BYTES_PER_PIXEL; pos++)
+    {
+        start[pos] = (unsigned char)rand();
+        end[pos] = (unsigned char)rand();
+    }
+
+    check_fade_kernels();
+    check_slide();
+    check_circle();
+
+    printf("compositor_kernel_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static void check_fade_kernels(void)
+{
+    for (int kernel = COMPOSITOR_KERNEL_SSE2; kernel <= COMPOSITOR_KERNEL_NEON; kernel++)
+    {
+        if (is_compositor_kernel_supported((COMPOSITOR_KERNEL)kernel) == false)
+        {
+            printf("compositor_kernel_test: %s not supported, skipped\n", kernel_names[kernel]);
+            continue;
+        }
+
+        for (size_t length = 0; length < sizeof(fade_lengths) / sizeof(fade_lengths[0]); length++)
+        {
+            int num_pixels = fade_lengths[length];
+
+            for (int alpha = 0; alpha < 256; alpha++)
+            {
+                //  The bytes past the end show whether a kernel wrote beyond num_pixels
+                memset(expected, 0xAB, sizeof(expected));
+                memset(actual, 0xAB, sizeof(actual));
+
+                CHECK(set_compositor_kernel(COMPOSITOR_KERNEL_SCALAR));
+                composite_fade(expected, start, end, num_pixels, (unsigned char)(255 - alpha), (unsigned char)alpha);
+
+                CHECK(set_compositor_kernel((COMPOSITOR_KERNEL)kernel));
+                composite_fade(actual, start, end, num_pixels, (unsigned char)(255 - alpha), (unsigned char)alpha);
+
+                if (memcmp(expected, actual, sizeof(actual)) != 0)
+                {
+                    printf("compositor_kernel_test: %s differs with %d pixels at alpha %d\n", kernel_names[kernel], num_pixels, alpha);
+                    failures++;
+                }
+            }
+        }
+    }
+}
+
+static void check_slide(void)
+{
+    for (int start_x = -TEST_WIDTH - 3; start_x <= TEST_WIDTH + 3; start_x++)
+    {
+        for (int end_x = -TEST_WIDTH - 3; end_x <= TEST_WIDTH + 3; end_x += 2)
+        {
+            composite_slide(actual, start, end, TEST_WIDTH, TEST_HEIGHT, start_x, end_x);
+
+            for (int y = 0; y < TEST_HEIGHT; y++)
+            {
+                for (int x = 0; x < TEST_WIDTH; x++)
+                {
+                    const unsigned char *pixel = actual + (((y * TEST_WIDTH) + x) * BYTES_PER_PIXEL);
+
+                    if (memcmp(pixel, get_slide_pixel(x, y, start_x, end_x), BYTES_PER_PIXEL) != 0)
+                    {
+                        printf("compositor_kernel_test: slide differs at %d,%d with start %d and end %d\n", x, y, start_x, end_x);
+                        failures++;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//  The end screen is on top, then the start screen, then black
+static const unsigned char *get_slide_pixel(int x, int y, int start_x, int end_x)
+{
+    static const unsigned char black[BYTES_PER_PIXEL] = { 0, 0, 0, 255 };
+
+    if (x >= end_x && x < end_x + TEST_WIDTH)
+    {
+        return end + (((y * TEST_WIDTH) + x - end_x) * BYTES_PER_PIXEL);
+    }
+
+    if (x >= start_x && x < start_x + TEST_WIDTH)
+    {
+        return start + (((y * TEST_WIDTH) + x - start_x) * BYTES_PER_PIXEL);
+    }
+
+    return black;
+}
+
+static void check_circle(void)
+{
+    static const float centres[][2] = { { 18.5f, 11.5f }, { 0.0f, 0.0f }, { 36.7f, 3.2f }, { -5.3f, 30.1f }, { 10.25f, 7.75f } };
+
+    for (size_t centre = 0; centre < sizeof(centres) / sizeof(centres[0]); centre++)
+    {
+        for (float radius = 0.0f; radius < 60.0f; radius += 0.37f)
+        {
+            float centre_x = centres[centre][0];
+            float centre_y = centres[centre][1];
+
+            composite_circle(actual, start, end, TEST_WIDTH, TEST_HEIGHT, centre_x, centre_y, radius);
+
+            for (int y = 0; y < TEST_HEIGHT; y++)
+            {
+                for (int x = 0; x < TEST_WIDTH; x++)
+                {
+                    int pos = ((y * TEST_WIDTH) + x) * BYTES_PER_PIXEL;
+                    float delta_x = ((float)x + 0.5f) - centre_x;
+                    float delta_y = ((float)y + 0.5f) - centre_y;
+                    bool inside = (delta_x * delta_x) + (delta_y * delta_y) < radius * radius;
+
+                    if (memcmp(actual + pos, (inside ? end : start) + pos, BYTES_PER_PIXEL) != 0)
+                    {
+                        printf("compositor_kernel_test: circle differs at %d,%d with centre %.2f,%.2f and radius %.2f\n", x, y, centre_x, centre_y, radius);
+                        failures++;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,299 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "scene_handler.h"
+#include "input_recorder.h"
+#include "raylib_mock.h"
+
+//  Records a session of input events and scene changes, replays it at a different frame rate, and checks the replay
+//  played the same events, made the same changes and wrote a report row per frame
+//  The recording ends part way through a fade, which carries on from where it was once the replay is over
+#define REPLAY_FRAMES 110
+#define REPLAY_FRAME_TIME (1.0f / 144.0f)
+#define SETTLE_FRAMES 1000
+#define RECORDING_PATH "build/tests/input_replay_test.rec"
+#define REPORT_PATH "build/tests/input_replay_test.csv"
+#define MAX_REPORT_LINE_LEN 256
+
+//  Changes are made during these frames, and replayed before the frame after
+#define NEXT_FRAME 20
+#define GO_TO_C_FRAME 70
+#define GO_TO_A_FRAME 100
+
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static const unsigned int event_frames[] = { 5, 40, 90 };
+
+static int failures = 0;
+static int entered = NO_SCENE;
+static float scene_time = 0.0f;
+static int played_events[REPLAY_FRAMES];
+
+static bool init_a(void);
+static bool init_b(void);
+static bool init_c(void);
+static void render_scene(void);
+static bool run_a(void);
+static bool run_b(void);
+static bool run_c(void);
+static void record_session(double *clock);
+static void replay_session(void);
+static void check_report(double clock);
+static int get_expected_scene(unsigned int frame);
+static int get_expected_events(unsigned int frame);
+static void run_until_settled(void);
+
+
+int main(void)
+{
+    double recorded_clock = 0.0;
+
+    add_scene("a", &init_a, &render_scene, &run_a, NULL, TRANSITION_FADE);
+    add_scene("b", &init_b, &render_scene, &run_b, NULL, TRANSITION_NONE);
+    add_scene("c", &init_c, &render_scene, &run_c, NULL, TRANSITION_FADE);
+
+    set_transition_duration(0.5f);
+
+    record_session(&recorded_clock);
+    float recorded_scene_time = scene_time;
+
+    replay_session();
+    CHECK(scene_time == recorded_scene_time);
+    CHECK(mock_played_events == (int)(sizeof(event_frames) / sizeof(event_frames[0])));
+
+    for (unsigned int frame = 0; frame < REPLAY_FRAMES; frame++)
+    {
+        CHECK(played_events[frame] == get_expected_events(frame));
+    }
+
+    check_report(recorded_clock);
+
+    //  The fade from c was a few frames in when the replay ended, so it neither jumps to its end nor stalls
+    mock_frame_time = 1.0f / 60.0f;
+
+    for (int frame = 0; frame < 10; frame++)
+    {
+        run_scene();
+        mock_time += mock_frame_time;
+    }
+
+    CHECK(is_transition_active());
+    CHECK(entered == 0);
+
+    for (int frame = 0; frame < 30 && is_transition_active(); frame++)
+    {
+        run_scene();
+        mock_time += mock_frame_time;
+    }
+
+    CHECK(is_transition_active() == false);
+
+    unload_transition_resources();
+
+    printf("input_replay_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static bool init_a(void)
+{
+    entered = 0;
+    return true;
+}
+
+static bool init_b(void)
+{
+    entered = 1;
+    return true;
+}
+
+static bool init_c(void)
+{
+    entered = 2;
+    return true;
+}
+
+static void render_scene(void)
+{
+}
+
+//  The scenes make the same changes on the same frames while replaying, which the replay ignores
+static bool run_a(void)
+{
+    BeginDrawing();
+    scene_time += get_scene_frame_time();
+
+    if (mock_frame_counter == NEXT_FRAME)
+    {
+        next_scene();
+    }
+
+    EndDrawing();
+
+    return true;
+}
+
+static bool run_b(void)
+{
+    BeginDrawing();
+    scene_time += get_scene_frame_time();
+
+    if (mock_frame_counter == GO_TO_C_FRAME)
+    {
+        go_to_scene(2);
+    }
+
+    EndDrawing();
+
+    return true;
+}
+
+static bool run_c(void)
+{
+    BeginDrawing();
+    scene_time += get_scene_frame_time();
+
+    if (mock_frame_counter == GO_TO_A_FRAME)
+    {
+        go_to_scene(0);
+    }
+
+    EndDrawing();
+
+    return true;
+}
+
+//  Frames alternate between 60 and 50 Hz, and the session stops part way through the fade from c
+static void record_session(double *clock)
+{
+    size_t next_event = 0;
+
+    CHECK(start_input_recording());
+    CHECK(first_scene());
+
+    for (unsigned int frame = 0; frame < REPLAY_FRAMES; frame++)
+    {
+        if (next_event < sizeof(event_frames) / sizeof(event_frames[0]) && event_frames[next_event] == frame)
+        {
+            mock_input_event((int)frame);
+            next_event++;
+        }
+
+        mock_frame_time = (frame % 2 == 0) ? 1.0f / 60.0f : 1.0f / 50.0f;
+        *clock += mock_frame_time;
+
+        run_scene();
+        mock_time += mock_frame_time;
+    }
+
+    CHECK(is_transition_active());
+    CHECK(stop_input_recording(RECORDING_PATH));
+
+    //  Replays start between transitions
+    run_until_settled();
+}
+
+static void replay_session(void)
+{
+    scene_time = 0.0f;
+    mock_played_events = 0;
+    mock_frame_counter = 0;
+    mock_frame_time = REPLAY_FRAME_TIME;
+
+    CHECK(start_input_replay(RECORDING_PATH, REPORT_PATH));
+
+    for (unsigned int frame = 0; frame < REPLAY_FRAMES; frame++)
+    {
+        CHECK(is_input_replay_active());
+
+        run_scene();
+        mock_time += mock_frame_time;
+
+        played_events[frame] = mock_played_events;
+    }
+
+    CHECK(is_input_replay_active() == false);
+}
+
+static void check_report(double clock)
+{
+    char line[MAX_REPORT_LINE_LEN];
+    unsigned int rows = 0;
+    double last_clock = 0.0;
+    FILE *file = fopen(REPORT_PATH, "r");
+
+    CHECK(file != NULL);
+
+    if (file == NULL)
+    {
+        return;
+    }
+
+    CHECK(fgets(line, MAX_REPORT_LINE_LEN, file) != NULL);
+
+    while (fgets(line, MAX_REPORT_LINE_LEN, file) != NULL)
+    {
+        unsigned int frame;
+        double frame_ms;
+        int scene_pos;
+        int transition;
+        int quality;
+        size_t live_bytes;
+        size_t high_water_bytes;
+
+        CHECK(sscanf(line, "%u,%lf,%lf,%d,%d,%d,%zu,%zu", &frame, &last_clock, &frame_ms, &scene_pos, &transition, &quality, &live_bytes, &high_water_bytes) == 8);
+        CHECK(frame == rows);
+        CHECK(scene_pos == get_expected_scene(frame));
+        CHECK(quality == TRANSITION_QUALITY_FULL);
+
+        //  The fades run from the frame after each change, and neither runs to the next
+        if (frame == NEXT_FRAME + 1 || frame > GO_TO_A_FRAME)
+        {
+            CHECK(transition == 1);
+        }
+        else if (frame <= NEXT_FRAME || frame > GO_TO_C_FRAME)
+        {
+            CHECK(transition == 0);
+        }
+
+        rows++;
+    }
+
+    fclose(file);
+
+    CHECK(rows == REPLAY_FRAMES);
+    CHECK(fabs(last_clock - clock) < 1e-4);
+}
+
+static int get_expected_scene(unsigned int frame)
+{
+    if (frame > GO_TO_A_FRAME || frame <= NEXT_FRAME)
+    {
+        return 0;
+    }
+
+    return (frame > GO_TO_C_FRAME) ? 2 : 1;
+}
+
+static int get_expected_events(unsigned int frame)
+{
+    int num_events = 0;
+
+    for (size_t event = 0; event < sizeof(event_frames) / sizeof(event_frames[0]); event++)
+    {
+        num_events += (event_frames[event] <= frame) ? 1 : 0;
+    }
+
+    return num_events;
+}
+
+static void run_until_settled(void)
+{
+    for (int frame = 0; frame < SETTLE_FRAMES && is_transition_active(); frame++)
+    {
+        run_scene();
+        mock_time += mock_frame_time;
+    }
+
+    CHECK(is_transition_active() == false);
+}
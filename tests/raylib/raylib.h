@@ -0,0 +1,163 @@
+#ifndef RAYLIB_H
+#define RAYLIB_H
+
+//  The subset of raylib 5 the scene handler uses, with the same types and signatures, for the mock in tests/raylib_mock.c
+
+#include <stdbool.h>
+
+typedef struct Vector2
+{
+    float x;
+    float y;
+} Vector2;
+
+typedef struct Color
+{
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+
+typedef struct Rectangle
+{
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+
+typedef struct Image
+{
+    void *data;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Image;
+
+typedef struct Texture
+{
+    unsigned int id;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Texture;
+
+typedef Texture Texture2D;
+
+typedef struct RenderTexture
+{
+    unsigned int id;
+    Texture texture;
+    Texture depth;
+} RenderTexture;
+
+typedef RenderTexture RenderTexture2D;
+
+typedef struct AutomationEvent
+{
+    unsigned int frame;
+    unsigned int type;
+    int params[4];
+} AutomationEvent;
+
+typedef struct AutomationEventList
+{
+    unsigned int capacity;
+    unsigned int count;
+    AutomationEvent *events;
+} AutomationEventList;
+
+#define CLITERAL(type) (type)
+
+#define WHITE CLITERAL(Color){ 255, 255, 255, 255 }
+#define BLACK CLITERAL(Color){ 0, 0, 0, 255 }
+#define BLANK CLITERAL(Color){ 0, 0, 0, 0 }
+
+typedef enum
+{
+    FLAG_VSYNC_HINT = 0x00000040
+} ConfigFlags;
+
+typedef enum
+{
+    LOG_ALL = 0,
+    LOG_TRACE,
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR,
+    LOG_FATAL,
+    LOG_NONE
+} TraceLogLevel;
+
+typedef enum
+{
+    PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 = 7
+} PixelFormat;
+
+typedef enum
+{
+    TEXTURE_FILTER_POINT = 0,
+    TEXTURE_FILTER_BILINEAR
+} TextureFilter;
+
+typedef enum
+{
+    BLEND_ALPHA = 0,
+    BLEND_ADDITIVE,
+    BLEND_MULTIPLIED,
+    BLEND_ADD_COLORS,
+    BLEND_SUBTRACT_COLORS,
+    BLEND_ALPHA_PREMULTIPLY,
+    BLEND_CUSTOM,
+    BLEND_CUSTOM_SEPARATE
+} BlendMode;
+
+int GetScreenWidth(void);
+int GetScreenHeight(void);
+int GetRenderWidth(void);
+int GetRenderHeight(void);
+bool IsWindowState(unsigned int flag);
+int GetCurrentMonitor(void);
+int GetMonitorRefreshRate(int monitor);
+double GetTime(void);
+float GetFrameTime(void);
+void TraceLog(int logLevel, const char *text, ...);
+
+void BeginDrawing(void);
+void EndDrawing(void);
+void ClearBackground(Color color);
+void BeginTextureMode(RenderTexture2D target);
+void EndTextureMode(void);
+
+Image LoadImageFromScreen(void);
+Image LoadImageFromTexture(Texture2D texture);
+void UnloadImage(Image image);
+bool ExportImage(Image image, const char *fileName);
+Image ImageCopy(Image image);
+void ImageFormat(Image *image, int newFormat);
+void ImageFlipVertical(Image *image);
+int GetPixelDataSize(int width, int height, int format);
+
+Texture2D LoadTextureFromImage(Image image);
+void UnloadTexture(Texture2D texture);
+void UpdateTexture(Texture2D texture, const void *pixels);
+void SetTextureFilter(Texture2D texture, int filter);
+RenderTexture2D LoadRenderTexture(int width, int height);
+void UnloadRenderTexture(RenderTexture2D target);
+
+void DrawTexture(Texture2D texture, int posX, int posY, Color tint);
+void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint);
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void DrawCircleV(Vector2 center, float radius, Color color);
+
+void SetAutomationEventList(AutomationEventList *list);
+void SetAutomationEventBaseFrame(int frame);
+void StartAutomationEventRecording(void);
+void StopAutomationEventRecording(void);
+void PlayAutomationEvent(AutomationEvent event);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef RAYMATH_H
+#define RAYMATH_H
+
+#include "raylib.h"
+
+static inline Vector2 Vector2Scale(Vector2 v, float scale)
+{
+    return (Vector2){ v.x * scale, v.y * scale };
+}
+
+#endif
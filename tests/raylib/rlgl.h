@@ -0,0 +1,20 @@
+#ifndef RLGL_H
+#define RLGL_H
+
+#define RL_READ_FRAMEBUFFER 0x8CA8
+#define RL_DRAW_FRAMEBUFFER 0x8CA9
+
+#define RL_ZERO 0
+#define RL_ONE 1
+#define RL_SRC_ALPHA 0x0302
+#define RL_ONE_MINUS_SRC_ALPHA 0x0303
+#define RL_FUNC_ADD 0x8006
+
+void rlDrawRenderBatchActive(void);
+void rlSetBlendMode(int mode);
+void rlSetBlendFactors(int glSrcFactor, int glDstFactor, int glEquation);
+void rlSetBlendFactorsSeparate(int glSrcRGB, int glDstRGB, int glSrcAlpha, int glDstAlpha, int glEqRGB, int glEqAlpha);
+void rlBindFramebuffer(unsigned int target, unsigned int framebuffer);
+void rlBlitFramebuffer(int srcX, int srcY, int srcWidth, int srcHeight, int dstX, int dstY, int dstWidth, int dstHeight, int bufferMask);
+
+#endif
@@ -0,0 +1,327 @@
+#include <raylib.h>
+#include <rlgl.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib_mock.h"
+
+#define MOCK_BYTES_PER_PIXEL 4
+
+int mock_live_images = 0;
+int mock_live_textures = 0;
+int mock_live_render_textures = 0;
+
+double mock_time = 0.0;
+float mock_frame_time = 1.0f / 60.0f;
+
+unsigned int mock_frame_counter = 0;
+int mock_played_events = 0;
+
+int mock_screen_width = 64;
+int mock_screen_height = 48;
+
+bool mock_vsync = false;
+int mock_refresh_rate = 60;
+
+static unsigned int next_id = 1;
+static AutomationEventList *event_list = NULL;
+static bool recording_events = false;
+
+static Image load_blank_image(int width, int height);
+
+
+int GetScreenWidth(void)
+{
+    return mock_screen_width;
+}
+
+int GetScreenHeight(void)
+{
+    return mock_screen_height;
+}
+
+int GetRenderWidth(void)
+{
+    return mock_screen_width;
+}
+
+int GetRenderHeight(void)
+{
+    return mock_screen_height;
+}
+
+bool IsWindowState(unsigned int flag)
+{
+    return (flag == FLAG_VSYNC_HINT) && mock_vsync;
+}
+
+int GetCurrentMonitor(void)
+{
+    return 0;
+}
+
+int GetMonitorRefreshRate(int monitor)
+{
+    (void)monitor;
+    return mock_refresh_rate;
+}
+
+double GetTime(void)
+{
+    return mock_time;
+}
+
+float GetFrameTime(void)
+{
+    return mock_frame_time;
+}
+
+void TraceLog(int logLevel, const char *text, ...)
+{
+    (void)logLevel;
+    (void)text;
+}
+
+void BeginDrawing(void)
+{
+}
+
+void EndDrawing(void)
+{
+    mock_frame_counter++;
+}
+
+void ClearBackground(Color color)
+{
+    (void)color;
+}
+
+void BeginTextureMode(RenderTexture2D target)
+{
+    (void)target;
+}
+
+void EndTextureMode(void)
+{
+}
+
+Image LoadImageFromScreen(void)
+{
+    return load_blank_image(mock_screen_width, mock_screen_height);
+}
+
+Image LoadImageFromTexture(Texture2D texture)
+{
+    return load_blank_image(texture.width, texture.height);
+}
+
+void UnloadImage(Image image)
+{
+    if (image.data != NULL)
+    {
+        free(image.data);
+        mock_live_images--;
+    }
+}
+
+bool ExportImage(Image image, const char *fileName)
+{
+    (void)image;
+    (void)fileName;
+
+    return true;
+}
+
+Image ImageCopy(Image image)
+{
+    Image copy = load_blank_image(image.width, image.height);
+
+    memcpy(copy.data, image.data, (size_t)image.width * image.height * MOCK_BYTES_PER_PIXEL);
+
+    return copy;
+}
+
+void ImageFormat(Image *image, int newFormat)
+{
+    image->format = newFormat;
+}
+
+void ImageFlipVertical(Image *image)
+{
+    (void)image;
+}
+
+int GetPixelDataSize(int width, int height, int format)
+{
+    (void)format;
+
+    return width * height * MOCK_BYTES_PER_PIXEL;
+}
+
+Texture2D LoadTextureFromImage(Image image)
+{
+    mock_live_textures++;
+
+    return (Texture2D){ next_id++, image.width, image.height, 1, image.format };
+}
+
+void UnloadTexture(Texture2D texture)
+{
+    if (texture.id > 0)
+    {
+        mock_live_textures--;
+    }
+}
+
+void UpdateTexture(Texture2D texture, const void *pixels)
+{
+    (void)texture;
+    (void)pixels;
+}
+
+void SetTextureFilter(Texture2D texture, int filter)
+{
+    (void)texture;
+    (void)filter;
+}
+
+RenderTexture2D LoadRenderTexture(int width, int height)
+{
+    RenderTexture2D target = { next_id++, { next_id++, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 }, { 0 } };
+
+    mock_live_render_textures++;
+
+    return target;
+}
+
+void UnloadRenderTexture(RenderTexture2D target)
+{
+    if (target.id > 0)
+    {
+        mock_live_render_textures--;
+    }
+}
+
+void DrawTexture(Texture2D texture, int posX, int posY, Color tint)
+{
+    (void)texture;
+    (void)posX;
+    (void)posY;
+    (void)tint;
+}
+
+void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint)
+{
+    (void)texture;
+    (void)source;
+    (void)position;
+    (void)tint;
+}
+
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    (void)texture;
+    (void)source;
+    (void)dest;
+    (void)origin;
+    (void)rotation;
+    (void)tint;
+}
+
+void DrawCircleV(Vector2 center, float radius, Color color)
+{
+    (void)center;
+    (void)radius;
+    (void)color;
+}
+
+void SetAutomationEventList(AutomationEventList *list)
+{
+    event_list = list;
+}
+
+void SetAutomationEventBaseFrame(int frame)
+{
+    mock_frame_counter = (unsigned int)frame;
+}
+
+void StartAutomationEventRecording(void)
+{
+    recording_events = true;
+}
+
+void StopAutomationEventRecording(void)
+{
+    recording_events = false;
+}
+
+void PlayAutomationEvent(AutomationEvent event)
+{
+    (void)event;
+
+    mock_played_events++;
+}
+
+//  Like raylib, events past the list's capacity are dropped without a word
+void mock_input_event(int value)
+{
+    if (recording_events && event_list != NULL && event_list->count < event_list->capacity)
+    {
+        event_list->events[event_list->count++] = (AutomationEvent){ mock_frame_counter, 1, { value, 0, 0, 0 } };
+    }
+}
+
+void rlDrawRenderBatchActive(void)
+{
+}
+
+void rlSetBlendMode(int mode)
+{
+    (void)mode;
+}
+
+void rlSetBlendFactors(int glSrcFactor, int glDstFactor, int glEquation)
+{
+    (void)glSrcFactor;
+    (void)glDstFactor;
+    (void)glEquation;
+}
+
+void rlSetBlendFactorsSeparate(int glSrcRGB, int glDstRGB, int glSrcAlpha, int glDstAlpha, int glEqRGB, int glEqAlpha)
+{
+    (void)glSrcRGB;
+    (void)glDstRGB;
+    (void)glSrcAlpha;
+    (void)glDstAlpha;
+    (void)glEqRGB;
+    (void)glEqAlpha;
+}
+
+void rlBindFramebuffer(unsigned int target, unsigned int framebuffer)
+{
+    (void)target;
+    (void)framebuffer;
+}
+
+void rlBlitFramebuffer(int srcX, int srcY, int srcWidth, int srcHeight, int dstX, int dstY, int dstWidth, int dstHeight, int bufferMask)
+{
+    (void)srcX;
+    (void)srcY;
+    (void)srcWidth;
+    (void)srcHeight;
+    (void)dstX;
+    (void)dstY;
+    (void)dstWidth;
+    (void)dstHeight;
+    (void)bufferMask;
+}
+
+static Image load_blank_image(int width, int height)
+{
+    Image image = { calloc((size_t)width * height, MOCK_BYTES_PER_PIXEL), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+    mock_live_images++;
+
+    return image;
+}
@@ -0,0 +1,31 @@
+#ifndef RAYLIB_MOCK_H
+#define RAYLIB_MOCK_H
+
+#include <stdbool.h>
+
+//  Headless stand-in for raylib so the tests and the bench run without a window or a GPU
+//  Resources are counted as they are loaded and unloaded, so tests can check nothing leaks
+
+extern int mock_live_images;
+extern int mock_live_textures;
+extern int mock_live_render_textures;
+
+//  Returned by GetTime() and GetFrameTime(), tests move them on by hand
+extern double mock_time;
+extern float mock_frame_time;
+
+//  Stands in for the frame counter EndDrawing() advances
+extern unsigned int mock_frame_counter;
+extern int mock_played_events;
+
+extern int mock_screen_width;
+extern int mock_screen_height;
+
+//  What IsWindowState(FLAG_VSYNC_HINT) and GetMonitorRefreshRate() report
+extern bool mock_vsync;
+extern int mock_refresh_rate;
+
+//  Adds an event to the list being recorded, as raylib does when it polls input
+void mock_input_event(int value);
+
+#endif
@@ -0,0 +1,87 @@
+#include <stdio.h>
+
+#include "scene_handler.h"
+
+//  next_scene() follows the heaviest available edge, stays put when a scene's edges are all unavailable, and only
+//  falls back to the order the scenes were added in for a scene without edges
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static int failures = 0;
+static int entered = NO_SCENE;
+static bool edge_open = false;
+
+static bool init_a(void);
+static bool init_b(void);
+static bool init_c(void);
+static void render_scene(void);
+static bool run_scene_method(void);
+static bool is_edge_open(void);
+
+
+int main(void)
+{
+    int a = add_scene("a", &init_a, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+    int b = add_scene("b", &init_b, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+    int c = add_scene("c", &init_c, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+
+    CHECK(add_scene_edge(a, c, 1.0f, &is_edge_open));
+    CHECK(add_scene_edge(b, a, 1.0f, &is_edge_open));
+    CHECK(add_scene_edge(b, c, 2.0f, NULL));
+    CHECK(first_scene());
+    CHECK(entered == a);
+
+    //  a's only edge is closed, so it doesn't fall through to b
+    CHECK(next_scene() == false);
+    CHECK(entered == a);
+
+    edge_open = true;
+    CHECK(next_scene());
+    CHECK(entered == c);
+
+    //  c has no edges, so it wraps round to a
+    CHECK(next_scene());
+    CHECK(entered == a);
+
+    //  b's heaviest edge wins over the lighter open one
+    CHECK(set_scene(b));
+    CHECK(next_scene());
+    CHECK(entered == c);
+
+    unload_transition_resources();
+
+    printf("scene_edge_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static bool init_a(void)
+{
+    entered = 0;
+    return true;
+}
+
+static bool init_b(void)
+{
+    entered = 1;
+    return true;
+}
+
+static bool init_c(void)
+{
+    entered = 2;
+    return true;
+}
+
+static void render_scene(void)
+{
+}
+
+static bool run_scene_method(void)
+{
+    return true;
+}
+
+static bool is_edge_open(void)
+{
+    return edge_open;
+}
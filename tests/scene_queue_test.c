@@ -0,0 +1,108 @@
+#include <stdio.h>
+
+#include "scene_handler.h"
+#include "raylib_mock.h"
+
+//  Changes queued behind a transition are all made once it completes, including those into scenes without
+//  a transition of their own, and setting a scene outright drops them
+#define QUEUE_FRAME_TIME (1.0 / 60.0)
+#define QUEUE_MAX_FRAMES 1000
+
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static int failures = 0;
+static char entered = 0;
+
+static bool init_a(void);
+static bool init_b(void);
+static bool init_c(void);
+static bool init_d(void);
+static void render_scene(void);
+static bool run_scene_method(void);
+static void run_until_settled(void);
+
+
+int main(void)
+{
+    add_scene("a", &init_a, &render_scene, &run_scene_method, NULL, TRANSITION_FADE);
+    add_scene("b", &init_b, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+    int c = add_scene("c", &init_c, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+    add_scene("d", &init_d, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+
+    set_transition_duration(0.1f);
+    set_transition_interrupt(TRANSITION_INTERRUPT_QUEUE);
+    first_scene();
+
+    //  a fades to b, and the three changes made during the fade are queued
+    next_scene();
+    CHECK(is_transition_active());
+
+    next_scene();
+    next_scene();
+    next_scene();
+
+    run_until_settled();
+    CHECK(entered == 'a');
+
+    //  The last change wrapped round to a, which fades, so queue another behind it and drop it with set_scene()
+    CHECK(next_scene());
+    CHECK(is_transition_active());
+    CHECK(next_scene());
+    CHECK(set_scene(c));
+
+    run_until_settled();
+    CHECK(entered == 'c');
+
+    CHECK(next_scene());
+    CHECK(entered == 'd');
+
+    unload_transition_resources();
+
+    printf("scene_queue_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static bool init_a(void)
+{
+    entered = 'a';
+    return true;
+}
+
+static bool init_b(void)
+{
+    entered = 'b';
+    return true;
+}
+
+static bool init_c(void)
+{
+    entered = 'c';
+    return true;
+}
+
+static bool init_d(void)
+{
+    entered = 'd';
+    return true;
+}
+
+static void render_scene(void)
+{
+}
+
+static bool run_scene_method(void)
+{
+    return true;
+}
+
+static void run_until_settled(void)
+{
+    for (int frame = 0; frame < QUEUE_MAX_FRAMES && is_transition_active(); frame++)
+    {
+        run_scene();
+        mock_time += QUEUE_FRAME_TIME;
+    }
+
+    CHECK(is_transition_active() == false);
+}
@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "scene_handler.h"
+
+//  Saves the scenes' state and restores it, including a scene with the longest name that fits, and checks snapshots
+//  with a corrupt or mismatched header or record are refused without restoring anything
+#define SNAPSHOT_PATH "build/tests/scene_snapshot_test.snap"
+#define CORRUPT_PATH "build/tests/scene_snapshot_test_corrupt.snap"
+#define MAX_SNAPSHOT_SIZE 4096
+
+//  Where scene_handler.c lays out the header fields and the first record's offset
+#define HEADER_MAGIC 0
+#define HEADER_VERSION 4
+#define HEADER_LAYOUT_HASH 8
+#define HEADER_SCENE_POS 12
+#define FIRST_RECORD_OFFSET 88
+
+#define LONGEST_NAME "a_scene_name_of_forty_nine_characters_12345678901"
+#define TOO_LONG_NAME "a_scene_name_of_fifty_characters_which_is_too_long"
+
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static int failures = 0;
+static int a_state = 0;
+static int b_state = 0;
+static int a_inits = 0;
+static int b_inits = 0;
+static int restores = 0;
+
+static unsigned char snapshot[MAX_SNAPSHOT_SIZE];
+static size_t snapshot_size = 0;
+
+static bool init_a(void);
+static bool init_b(void);
+static void render_scene(void);
+static bool run_scene_method(void);
+static size_t serialize_a(void *buffer, size_t size);
+static bool restore_a(const void *buffer, size_t size);
+static size_t serialize_b(void *buffer, size_t size);
+static bool restore_b(const void *buffer, size_t size);
+static size_t serialize_state(const int *state, void *buffer, size_t size);
+static bool restore_state(int *state, const void *buffer, size_t size);
+static void check_corrupt(size_t pos, const void *bytes, size_t num_bytes, size_t size);
+
+
+int main(void)
+{
+    uint32_t bad_word = 0xFFFFFFFFu;
+    uint64_t bad_offset = MAX_SNAPSHOT_SIZE;
+    int32_t bad_scene_pos = 3;
+
+    CHECK(add_scene(TOO_LONG_NAME, &init_b, &render_scene, &run_scene_method, NULL, TRANSITION_NONE) == NO_SCENE);
+
+    int a = add_scene("a", &init_a, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+    int b = add_scene(LONGEST_NAME, &init_b, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+    add_scene("c", NULL, &render_scene, &run_scene_method, NULL, TRANSITION_NONE);
+
+    CHECK(b != NO_SCENE);
+    CHECK(find_scene_pos(LONGEST_NAME) == b);
+    CHECK(set_scene_snapshot(a, &serialize_a, &restore_a));
+    CHECK(set_scene_snapshot(b, &serialize_b, &restore_b));
+
+    CHECK(first_scene());
+    CHECK(set_scene(b));
+    a_state = 7;
+    b_state = 9;
+    CHECK(save_scene_snapshot(SNAPSHOT_PATH));
+
+    FILE *file = fopen(SNAPSHOT_PATH, "rb");
+
+    CHECK(file != NULL);
+
+    if (file != NULL)
+    {
+        snapshot_size = fread(snapshot, 1, MAX_SNAPSHOT_SIZE, file);
+        fclose(file);
+    }
+
+    //  Corrupt copies are refused before any scene's state is touched
+    a_state = 0;
+    b_state = 0;
+    check_corrupt(HEADER_MAGIC, &bad_word, sizeof(bad_word), snapshot_size);
+    check_corrupt(HEADER_VERSION, &bad_word, sizeof(bad_word), snapshot_size);
+    check_corrupt(HEADER_LAYOUT_HASH, &bad_word, sizeof(bad_word), snapshot_size);
+    check_corrupt(HEADER_SCENE_POS, &bad_scene_pos, sizeof(bad_scene_pos), snapshot_size);
+    check_corrupt(FIRST_RECORD_OFFSET, &bad_offset, sizeof(bad_offset), snapshot_size);
+    check_corrupt(0, NULL, 0, snapshot_size - 1);
+    CHECK(restores == 0);
+
+    //  Both scenes come back, and neither runs its init method when entered
+    int inits = a_inits + b_inits;
+
+    CHECK(restore_scene_snapshot(SNAPSHOT_PATH));
+    CHECK(restores == 2);
+    CHECK(a_state == 7);
+    CHECK(b_state == 9);
+    CHECK(set_scene(a));
+    CHECK(a_inits + b_inits == inits);
+
+    //  Only once, after that the scene starts afresh
+    CHECK(set_scene(b));
+    CHECK(b_inits == 2);
+
+    close_scene_snapshot();
+    remove(SNAPSHOT_PATH);
+    remove(CORRUPT_PATH);
+
+    printf("scene_snapshot_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static bool init_a(void)
+{
+    a_inits++;
+    return true;
+}
+
+static bool init_b(void)
+{
+    b_inits++;
+    return true;
+}
+
+static void render_scene(void)
+{
+}
+
+static bool run_scene_method(void)
+{
+    return true;
+}
+
+static size_t serialize_a(void *buffer, size_t size)
+{
+    return serialize_state(&a_state, buffer, size);
+}
+
+static bool restore_a(const void *buffer, size_t size)
+{
+    return restore_state(&a_state, buffer, size);
+}
+
+static size_t serialize_b(void *buffer, size_t size)
+{
+    return serialize_state(&b_state, buffer, size);
+}
+
+static bool restore_b(const void *buffer, size_t size)
+{
+    return restore_state(&b_state, buffer, size);
+}
+
+static size_t serialize_state(const int *state, void *buffer, size_t size)
+{
+    if (buffer != NULL && size >= sizeof(int))
+    {
+        memcpy(buffer, state, sizeof(int));
+    }
+
+    return sizeof(int);
+}
+
+static bool restore_state(int *state, const void *buffer, size_t size)
+{
+    restores++;
+
+    if (size != sizeof(int))
+    {
+        return false;
+    }
+
+    memcpy(state, buffer, sizeof(int));
+
+    return true;
+}
+
+//  Writes the saved snapshot with num_bytes at pos replaced and cut to size, which must then be refused
+static void check_corrupt(size_t pos, const void *bytes, size_t num_bytes, size_t size)
+{
+    unsigned char corrupt[MAX_SNAPSHOT_SIZE];
+
+    memcpy(corrupt, snapshot, snapshot_size);
+
+    if (bytes != NULL)
+    {
+        memcpy(corrupt + pos, bytes, num_bytes);
+    }
+
+    FILE *file = fopen(CORRUPT_PATH, "wb");
+
+    CHECK(file != NULL);
+
+    if (file != NULL)
+    {
+        fwrite(corrupt, 1, size, file);
+        fclose(file);
+    }
+
+    CHECK(restore_scene_snapshot(CORRUPT_PATH) == false);
+    CHECK(a_state == 0 && b_state == 0);
+}
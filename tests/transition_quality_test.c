@@ -0,0 +1,113 @@
+#include <stdio.h>
+
+#include "scene_handler.h"
+#include "raylib_mock.h"
+
+//  Quality follows the interval between transition frames, and with vsync on only frames that miss a refresh count
+//  Only circles have cheaper levels, so slow fades leave the quality alone
+#define QUALITY_BUDGET (1.0f / 100.0f)
+#define QUALITY_MAX_FRAMES 1000
+
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static int failures = 0;
+static int quality_changes = 0;
+static int circle_pos = 0;
+
+static void render_scene(void);
+static bool run_scene_method(void);
+static void on_quality_change(TRANSITION_QUALITY old_quality, TRANSITION_QUALITY new_quality, float frame_cost);
+static void run_circle_transition(double frame_time);
+static void run_transition_frames(int scene_pos, double frame_time);
+
+
+int main(void)
+{
+    add_scene("circle", NULL, &render_scene, &run_scene_method, NULL, TRANSITION_CIRCLE_EXPAND);
+    add_scene("other", NULL, &render_scene, &run_scene_method, NULL, TRANSITION_CIRCLE_CONTRACT);
+    int fade = add_scene("fade", NULL, &render_scene, &run_scene_method, NULL, TRANSITION_FADE);
+
+    set_transition_duration(0.5f);
+    set_transition_frame_budget(QUALITY_BUDGET);
+    set_transition_quality_callback(&on_quality_change);
+    first_scene();
+
+    //  Held to 60 Hz by vsync, which is over the budget but can't be helped
+    mock_vsync = true;
+    run_circle_transition(1.0 / 60.0);
+    CHECK(get_transition_quality() == TRANSITION_QUALITY_FULL);
+    CHECK(quality_changes == 0);
+
+    //  Every other refresh missed
+    run_circle_transition(2.0 / 60.0);
+    CHECK(get_transition_quality() > TRANSITION_QUALITY_FULL);
+    CHECK(quality_changes > 0);
+
+    //  Back on every refresh, so each transition from the one after next wins a level back
+    for (int transition = 0; transition < 4; transition++)
+    {
+        run_circle_transition(1.0 / 60.0);
+    }
+
+    CHECK(get_transition_quality() == TRANSITION_QUALITY_FULL);
+
+    //  A fade missing every other refresh has nothing cheaper to drop to
+    quality_changes = 0;
+    run_transition_frames(fade, 1.0 / 60.0);
+    run_transition_frames(circle_pos, 2.0 / 60.0);
+    CHECK(get_transition_quality() == TRANSITION_QUALITY_FULL);
+    CHECK(quality_changes == 0);
+
+    //  Without vsync the same 60 Hz frames are over the budget
+    mock_vsync = false;
+    quality_changes = 0;
+    run_circle_transition(1.0 / 60.0);
+    CHECK(get_transition_quality() > TRANSITION_QUALITY_FULL);
+    CHECK(quality_changes > 0);
+
+    unload_transition_resources();
+
+    printf("transition_quality_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static void render_scene(void)
+{
+}
+
+static bool run_scene_method(void)
+{
+    return true;
+}
+
+static void on_quality_change(TRANSITION_QUALITY old_quality, TRANSITION_QUALITY new_quality, float frame_cost)
+{
+    (void)old_quality;
+    (void)new_quality;
+    (void)frame_cost;
+
+    quality_changes++;
+}
+
+//  Goes back and forth between the two circle scenes
+static void run_circle_transition(double frame_time)
+{
+    circle_pos = (circle_pos == 0) ? 1 : 0;
+    run_transition_frames(circle_pos, frame_time);
+}
+
+//  Starts the transition to scene_pos and runs it to the end with every frame taking frame_time
+static void run_transition_frames(int scene_pos, double frame_time)
+{
+    go_to_scene(scene_pos);
+    CHECK(is_transition_active());
+
+    for (int frame = 0; frame < QUALITY_MAX_FRAMES && is_transition_active(); frame++)
+    {
+        run_scene();
+        mock_time += frame_time;
+    }
+
+    CHECK(is_transition_active() == false);
+}
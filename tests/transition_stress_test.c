@@ -0,0 +1,127 @@
+#include <stdio.h>
+
+#include "scene_handler.h"
+#include "memory_tracker.h"
+#include "raylib_mock.h"
+
+//  Interrupts transitions over and over, in both interrupt modes and with both compositors,
+//  and checks the transition resources and tracked memory stay flat throughout
+#define STRESS_SCENES 5
+#define STRESS_CHANGES 10000
+#define STRESS_FRAME_TIME (1.0 / 60.0)
+
+#define CHECK(condition) if ((condition) == false) { printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; }
+
+static int failures = 0;
+
+static void render_scene(void);
+static bool run_scene_method(void);
+static void run_frame(void);
+static int get_live_resources(void);
+
+
+int main(void)
+{
+    for (int scene = 0; scene < STRESS_SCENES; scene++)
+    {
+        add_scene("stress", NULL, &render_scene, &run_scene_method, NULL, (TRANSITION_TYPE)(TRANSITION_FADE + (scene % (TRANSITION_ALL - 1))));
+    }
+
+    set_transition_duration(0.1f);
+    first_scene();
+
+    for (int mode = TRANSITION_INTERRUPT_RETARGET; mode <= TRANSITION_INTERRUPT_QUEUE; mode++)
+    {
+        for (int compositor = TRANSITION_COMPOSITOR_GPU; compositor <= TRANSITION_COMPOSITOR_CPU; compositor++)
+        {
+            int settled_resources = -1;
+            size_t settled_bytes = 0;
+
+            set_transition_interrupt((TRANSITION_INTERRUPT)mode);
+            set_transition_compositor((TRANSITION_COMPOSITOR)compositor);
+
+            for (int change = 0; change < STRESS_CHANGES; change++)
+            {
+                next_scene();
+                run_frame();
+
+                //  Every third change interrupts the transition the one before started
+                if (change % 3 == 0)
+                {
+                    next_scene();
+                }
+
+                run_frame();
+
+                CHECK(check_transition_invariants());
+
+                //  The persistent textures are all loaded by the end of the first pass over the scenes
+                if (change == STRESS_SCENES * 2)
+                {
+                    settled_resources = get_live_resources();
+                    settled_bytes = get_memory_usage(MEMORY_ALL).high_water_bytes;
+                }
+                else if (change > STRESS_SCENES * 2)
+                {
+                    CHECK(get_live_resources() <= settled_resources);
+                    CHECK(get_memory_usage(MEMORY_ALL).live_bytes <= settled_bytes);
+                }
+            }
+
+            //  Let whatever is running or queued finish
+            for (int frame = 0; frame < 1000 && is_transition_active(); frame++)
+            {
+                run_frame();
+            }
+
+            CHECK(is_transition_active() == false);
+            CHECK(check_transition_invariants());
+        }
+    }
+
+    //  Transitions restarted straight over a running CPU composite, which nothing else stops first
+    set_transition_compositor(TRANSITION_COMPOSITOR_CPU);
+    set_transition_start_screen();
+    set_transition_end_screen(&render_scene);
+
+    for (int change = 0; change < STRESS_CHANGES / 100; change++)
+    {
+        start_transition(TRANSITION_FADE);
+        run_transition();
+
+        CHECK(check_transition_invariants());
+        CHECK(get_transition_resources().textures <= 2);
+    }
+
+    stop_transition();
+    unload_transition_resources();
+
+    CHECK(mock_live_images == 0);
+    CHECK(mock_live_textures == 0);
+    CHECK(mock_live_render_textures == 0);
+    CHECK(get_memory_usage(MEMORY_ALL).live_bytes == 0);
+
+    printf("transition_stress_test: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
+
+static void render_scene(void)
+{
+}
+
+static bool run_scene_method(void)
+{
+    return true;
+}
+
+static void run_frame(void)
+{
+    run_scene();
+    mock_time += STRESS_FRAME_TIME;
+}
+
+static int get_live_resources(void)
+{
+    return mock_live_images + mock_live_textures + mock_live_render_textures;
+}
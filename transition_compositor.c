@@ -0,0 +1,432 @@
+#include "scene_handler_config.h"
+
+#if SCENE_HANDLER_TRANSITIONS
+
+#include <string.h>
+#include <math.h>
+
+#include "transition_compositor.h"
+
+#if defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64)
+#define COMPOSITOR_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+//  AVX2 is compiled in per function and only selected when the CPU reports it at runtime
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define COMPOSITOR_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define COMPOSITOR_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#define BYTES_PER_PIXEL 4
+#define OPAQUE_ALPHA_MASK 0xFF000000u
+
+typedef void (*FADE_KERNEL)(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha);
+
+static COMPOSITOR_KERNEL active_kernel = COMPOSITOR_KERNEL_AUTO;
+static FADE_KERNEL fade_kernel = NULL;
+
+static unsigned int div_255(unsigned int value);
+static void fade_scalar(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha);
+#ifdef COMPOSITOR_HAS_SSE2
+static void fade_sse2(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha);
+#endif
+#ifdef COMPOSITOR_HAS_AVX2
+static void fade_avx2(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha);
+#endif
+#ifdef COMPOSITOR_HAS_NEON
+static void fade_neon(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha);
+#endif
+static COMPOSITOR_KERNEL get_best_kernel(void);
+static int clamp_x(int x, int width);
+static void fill_black(unsigned char *row, int from, int to);
+static void copy_span(unsigned char *row, const unsigned char *src_row, int src_x, int from, int to);
+static void draw_span(unsigned char *row, const unsigned char *src_row, int src_x, int width, int from, int to);
+
+
+bool set_compositor_kernel(COMPOSITOR_KERNEL kernel)
+{
+    if (kernel == COMPOSITOR_KERNEL_AUTO)
+    {
+        kernel = get_best_kernel();
+    }
+
+    if (is_compositor_kernel_supported(kernel) == false)
+    {
+        return false;
+    }
+
+    switch(kernel)
+    {
+#ifdef COMPOSITOR_HAS_SSE2
+        case COMPOSITOR_KERNEL_SSE2:
+            fade_kernel = &fade_sse2;
+            break;
+#endif
+
+#ifdef COMPOSITOR_HAS_AVX2
+        case COMPOSITOR_KERNEL_AVX2:
+            fade_kernel = &fade_avx2;
+            break;
+#endif
+
+#ifdef COMPOSITOR_HAS_NEON
+        case COMPOSITOR_KERNEL_NEON:
+            fade_kernel = &fade_neon;
+            break;
+#endif
+
+        default:
+            fade_kernel = &fade_scalar;
+    }
+
+    active_kernel = kernel;
+
+    return true;
+}
+
+COMPOSITOR_KERNEL get_compositor_kernel(void)
+{
+    if (fade_kernel == NULL)
+    {
+        set_compositor_kernel(COMPOSITOR_KERNEL_AUTO);
+    }
+
+    return active_kernel;
+}
+
+bool is_compositor_kernel_supported(COMPOSITOR_KERNEL kernel)
+{
+    switch(kernel)
+    {
+        case COMPOSITOR_KERNEL_AUTO:
+        case COMPOSITOR_KERNEL_SCALAR:
+            return true;
+
+#ifdef COMPOSITOR_HAS_SSE2
+        case COMPOSITOR_KERNEL_SSE2:
+            return true;
+#endif
+
+#ifdef COMPOSITOR_HAS_AVX2
+        case COMPOSITOR_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+
+#ifdef COMPOSITOR_HAS_NEON
+        case COMPOSITOR_KERNEL_NEON:
+            return true;
+#endif
+
+        default:
+            return false;
+    }
+}
+
+void composite_fade(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha)
+{
+    if (fade_kernel == NULL)
+    {
+        set_compositor_kernel(COMPOSITOR_KERNEL_AUTO);
+    }
+
+    fade_kernel(dest, start, end, num_pixels, start_alpha, end_alpha);
+}
+
+void composite_slide(unsigned char *dest, const unsigned char *start, const unsigned char *end, int width, int height, int start_x, int end_x)
+{
+    int stride = width * BYTES_PER_PIXEL;
+    int end_from = clamp_x(end_x, width);
+    int end_to = clamp_x(end_x + width, width);
+
+    //  Every pixel is written once: the end screen is on top, the start screen or black either side of it
+    for (int y = 0; y < height; y++)
+    {
+        unsigned char *row = dest + (y * stride);
+        const unsigned char *start_row = start + (y * stride);
+
+        draw_span(row, start_row, start_x, width, 0, end_from);
+        copy_span(row, end + (y * stride), end_x, end_from, end_to);
+        draw_span(row, start_row, start_x, width, end_to, width);
+    }
+}
+
+void composite_circle(unsigned char *dest, const unsigned char *outside, const unsigned char *inside, int width, int height, float centre_x, float centre_y, float radius)
+{
+    int stride = width * BYTES_PER_PIXEL;
+    float radius_squared = radius * radius;
+
+    //  The circle is a single span per row, so each row is at most three straight copies
+    for (int y = 0; y < height; y++)
+    {
+        unsigned char *row = dest + (y * stride);
+        const unsigned char *outside_row = outside + (y * stride);
+        float delta_y = ((float)y + 0.5f) - centre_y;
+        float span_squared = radius_squared - (delta_y * delta_y);
+
+        if (span_squared <= 0.0f)
+        {
+            memcpy(row, outside_row, stride);
+            continue;
+        }
+
+        float span = sqrtf(span_squared);
+        int inside_from = clamp_x((int)floorf(centre_x - span - 0.5f) + 1, width);
+        int inside_to = clamp_x((int)ceilf(centre_x + span - 0.5f), width);
+
+        if (inside_to < inside_from)
+        {
+            inside_to = inside_from;
+        }
+
+        copy_span(row, outside_row, 0, 0, inside_from);
+        copy_span(row, inside + (y * stride), 0, inside_from, inside_to);
+        copy_span(row, outside_row, 0, inside_to, width);
+    }
+}
+
+//  Exact rounded division by 255 for any product of two bytes
+static unsigned int div_255(unsigned int value)
+{
+    value += 128;
+
+    return (value + (value >> 8)) >> 8;
+}
+
+static void fade_scalar(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha)
+{
+    unsigned int inverse_end_alpha = 255 - end_alpha;
+
+    for (int pos = 0; pos < num_pixels * BYTES_PER_PIXEL; pos += BYTES_PER_PIXEL)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            unsigned int faded_start = div_255(start[pos + channel] * start_alpha);
+
+            dest[pos + channel] = (unsigned char)div_255((end[pos + channel] * end_alpha) + (faded_start * inverse_end_alpha));
+        }
+
+        dest[pos + 3] = 255;
+    }
+}
+
+#ifdef COMPOSITOR_HAS_SSE2
+static __m128i div_255_sse2(__m128i value)
+{
+    value = _mm_add_epi16(value, _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+static __m128i fade_half_sse2(__m128i start, __m128i end, __m128i start_alpha, __m128i end_alpha, __m128i inverse_end_alpha)
+{
+    __m128i faded_start = div_255_sse2(_mm_mullo_epi16(start, start_alpha));
+
+    return div_255_sse2(_mm_add_epi16(_mm_mullo_epi16(end, end_alpha), _mm_mullo_epi16(faded_start, inverse_end_alpha)));
+}
+
+static void fade_sse2(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32((int)OPAQUE_ALPHA_MASK);
+    const __m128i start_alpha_16 = _mm_set1_epi16(start_alpha);
+    const __m128i end_alpha_16 = _mm_set1_epi16(end_alpha);
+    const __m128i inverse_end_alpha_16 = _mm_set1_epi16(255 - end_alpha);
+    int pixel = 0;
+
+    for (; pixel + 4 <= num_pixels; pixel += 4)
+    {
+        int pos = pixel * BYTES_PER_PIXEL;
+        __m128i start_pixels = _mm_loadu_si128((const __m128i *)(start + pos));
+        __m128i end_pixels = _mm_loadu_si128((const __m128i *)(end + pos));
+
+        __m128i low = fade_half_sse2(_mm_unpacklo_epi8(start_pixels, zero), _mm_unpacklo_epi8(end_pixels, zero), start_alpha_16, end_alpha_16, inverse_end_alpha_16);
+        __m128i high = fade_half_sse2(_mm_unpackhi_epi8(start_pixels, zero), _mm_unpackhi_epi8(end_pixels, zero), start_alpha_16, end_alpha_16, inverse_end_alpha_16);
+
+        _mm_storeu_si128((__m128i *)(dest + pos), _mm_or_si128(_mm_packus_epi16(low, high), opaque));
+    }
+
+    if (pixel < num_pixels)
+    {
+        int pos = pixel * BYTES_PER_PIXEL;
+
+        fade_scalar(dest + pos, start + pos, end + pos, num_pixels - pixel, start_alpha, end_alpha);
+    }
+}
+#endif
+
+#ifdef COMPOSITOR_HAS_AVX2
+__attribute__((target("avx2")))
+static __m256i div_255_avx2(__m256i value)
+{
+    value = _mm256_add_epi16(value, _mm256_set1_epi16(128));
+
+    return _mm256_srli_epi16(_mm256_add_epi16(value, _mm256_srli_epi16(value, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+static __m256i fade_half_avx2(__m256i start, __m256i end, __m256i start_alpha, __m256i end_alpha, __m256i inverse_end_alpha)
+{
+    __m256i faded_start = div_255_avx2(_mm256_mullo_epi16(start, start_alpha));
+
+    return div_255_avx2(_mm256_add_epi16(_mm256_mullo_epi16(end, end_alpha), _mm256_mullo_epi16(faded_start, inverse_end_alpha)));
+}
+
+//  Unpack and pack both work within 128 bit lanes, so the pixel order is preserved
+__attribute__((target("avx2")))
+static void fade_avx2(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi32((int)OPAQUE_ALPHA_MASK);
+    const __m256i start_alpha_16 = _mm256_set1_epi16(start_alpha);
+    const __m256i end_alpha_16 = _mm256_set1_epi16(end_alpha);
+    const __m256i inverse_end_alpha_16 = _mm256_set1_epi16(255 - end_alpha);
+    int pixel = 0;
+
+    for (; pixel + 8 <= num_pixels; pixel += 8)
+    {
+        int pos = pixel * BYTES_PER_PIXEL;
+        __m256i start_pixels = _mm256_loadu_si256((const __m256i *)(start + pos));
+        __m256i end_pixels = _mm256_loadu_si256((const __m256i *)(end + pos));
+
+        __m256i low = fade_half_avx2(_mm256_unpacklo_epi8(start_pixels, zero), _mm256_unpacklo_epi8(end_pixels, zero), start_alpha_16, end_alpha_16, inverse_end_alpha_16);
+        __m256i high = fade_half_avx2(_mm256_unpackhi_epi8(start_pixels, zero), _mm256_unpackhi_epi8(end_pixels, zero), start_alpha_16, end_alpha_16, inverse_end_alpha_16);
+
+        _mm256_storeu_si256((__m256i *)(dest + pos), _mm256_or_si256(_mm256_packus_epi16(low, high), opaque));
+    }
+
+    if (pixel < num_pixels)
+    {
+        int pos = pixel * BYTES_PER_PIXEL;
+
+        fade_scalar(dest + pos, start + pos, end + pos, num_pixels - pixel, start_alpha, end_alpha);
+    }
+}
+#endif
+
+#ifdef COMPOSITOR_HAS_NEON
+static uint16x8_t div_255_neon(uint16x8_t value)
+{
+    value = vaddq_u16(value, vdupq_n_u16(128));
+
+    return vshrq_n_u16(vaddq_u16(value, vshrq_n_u16(value, 8)), 8);
+}
+
+static uint8x8_t fade_half_neon(uint8x8_t start, uint8x8_t end, uint16x8_t start_alpha, uint16x8_t end_alpha, uint16x8_t inverse_end_alpha)
+{
+    uint16x8_t faded_start = div_255_neon(vmulq_u16(vmovl_u8(start), start_alpha));
+
+    return vmovn_u16(div_255_neon(vaddq_u16(vmulq_u16(vmovl_u8(end), end_alpha), vmulq_u16(faded_start, inverse_end_alpha))));
+}
+
+static void fade_neon(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha)
+{
+    const uint8x16_t opaque = vreinterpretq_u8_u32(vdupq_n_u32(OPAQUE_ALPHA_MASK));
+    const uint16x8_t start_alpha_16 = vdupq_n_u16(start_alpha);
+    const uint16x8_t end_alpha_16 = vdupq_n_u16(end_alpha);
+    const uint16x8_t inverse_end_alpha_16 = vdupq_n_u16(255 - end_alpha);
+    int pixel = 0;
+
+    for (; pixel + 4 <= num_pixels; pixel += 4)
+    {
+        int pos = pixel * BYTES_PER_PIXEL;
+        uint8x16_t start_pixels = vld1q_u8(start + pos);
+        uint8x16_t end_pixels = vld1q_u8(end + pos);
+
+        uint8x8_t low = fade_half_neon(vget_low_u8(start_pixels), vget_low_u8(end_pixels), start_alpha_16, end_alpha_16, inverse_end_alpha_16);
+        uint8x8_t high = fade_half_neon(vget_high_u8(start_pixels), vget_high_u8(end_pixels), start_alpha_16, end_alpha_16, inverse_end_alpha_16);
+
+        vst1q_u8(dest + pos, vorrq_u8(vcombine_u8(low, high), opaque));
+    }
+
+    if (pixel < num_pixels)
+    {
+        int pos = pixel * BYTES_PER_PIXEL;
+
+        fade_scalar(dest + pos, start + pos, end + pos, num_pixels - pixel, start_alpha, end_alpha);
+    }
+}
+#endif
+
+static COMPOSITOR_KERNEL get_best_kernel(void)
+{
+    if (is_compositor_kernel_supported(COMPOSITOR_KERNEL_AVX2))
+    {
+        return COMPOSITOR_KERNEL_AVX2;
+    }
+
+    if (is_compositor_kernel_supported(COMPOSITOR_KERNEL_SSE2))
+    {
+        return COMPOSITOR_KERNEL_SSE2;
+    }
+
+    if (is_compositor_kernel_supported(COMPOSITOR_KERNEL_NEON))
+    {
+        return COMPOSITOR_KERNEL_NEON;
+    }
+
+    return COMPOSITOR_KERNEL_SCALAR;
+}
+
+static int clamp_x(int x, int width)
+{
+    if (x < 0)
+    {
+        return 0;
+    }
+
+    return (x > width) ? width : x;
+}
+
+static void fill_black(unsigned char *row, int from, int to)
+{
+    static const unsigned char black[BYTES_PER_PIXEL] = { 0, 0, 0, 255 };
+
+    for (int x = from; x < to; x++)
+    {
+        memcpy(row + (x * BYTES_PER_PIXEL), black, BYTES_PER_PIXEL);
+    }
+}
+
+//  Copies destination pixels [from, to) from a source row that is placed at src_x
+static void copy_span(unsigned char *row, const unsigned char *src_row, int src_x, int from, int to)
+{
+    if (to > from)
+    {
+        memcpy(row + (from * BYTES_PER_PIXEL), src_row + ((from - src_x) * BYTES_PER_PIXEL), (to - from) * BYTES_PER_PIXEL);
+    }
+}
+
+//  As copy_span(), but any part of [from, to) the source row doesn't cover is black
+static void draw_span(unsigned char *row, const unsigned char *src_row, int src_x, int width, int from, int to)
+{
+    int src_from = clamp_x(src_x, width);
+    int src_to = clamp_x(src_x + width, width);
+
+    if (src_from < from)
+    {
+        src_from = from;
+    }
+
+    if (src_to > to)
+    {
+        src_to = to;
+    }
+
+    if (src_to <= src_from)
+    {
+        fill_black(row, from, to);
+        return;
+    }
+
+    fill_black(row, from, src_from);
+    copy_span(row, src_row, src_x, src_from, src_to);
+    fill_black(row, src_to, to);
+}
+
+#endif
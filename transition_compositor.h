@@ -0,0 +1,29 @@
+#ifndef TRANSITION_COMPOSITOR_H
+#define TRANSITION_COMPOSITOR_H
+
+#include <stdbool.h>
+
+//  Software compositing of transition frames on RGBA8 pixel buffers, for targets without a GPU
+typedef enum
+{
+    COMPOSITOR_KERNEL_AUTO = 0,
+    COMPOSITOR_KERNEL_SCALAR,
+    COMPOSITOR_KERNEL_SSE2,
+    COMPOSITOR_KERNEL_AVX2,
+    COMPOSITOR_KERNEL_NEON
+} COMPOSITOR_KERNEL;
+
+bool set_compositor_kernel(COMPOSITOR_KERNEL kernel);
+COMPOSITOR_KERNEL get_compositor_kernel(void);
+bool is_compositor_kernel_supported(COMPOSITOR_KERNEL kernel);
+
+//  Matches the GPU path: start drawn over black with start_alpha, then end blended over with end_alpha
+void composite_fade(unsigned char *dest, const unsigned char *start, const unsigned char *end, int num_pixels, unsigned char start_alpha, unsigned char end_alpha);
+
+//  start_x and end_x are the destination x positions of each screen, uncovered pixels are black
+void composite_slide(unsigned char *dest, const unsigned char *start, const unsigned char *end, int width, int height, int start_x, int end_x);
+
+//  Pixels whose centre is inside the circle come from inside, the rest from outside
+void composite_circle(unsigned char *dest, const unsigned char *outside, const unsigned char *inside, int width, int height, float centre_x, float centre_y, float radius);
+
+#endif
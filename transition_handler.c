@@ -1,3 +1,7 @@
+#include "scene_handler_config.h"
+
+#if SCENE_HANDLER_TRANSITIONS
+
 #include <raylib.h>
 #include <raymath.h>
 #include <rlgl.h>
@@ -6,22 +10,40 @@
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
-#include <sys/time.h>
 
 #include "transition_handler.h"
+#include "transition_compositor.h"
+#include "memory_tracker.h"
+#include "frame_capture.h"
 
 //  Constants from OpenGL
 #define GL_SRC_ALPHA 0x0302
 #define GL_MIN 0x8007
 
+#define EASING_TABLE_SIZE 256
+
+//  Frame cost is smoothed, and a change of quality is given time to take effect before the next
+#define FRAME_COST_SMOOTHING 0.25f
+#define QUALITY_SETTLE_FRAMES 5
+#define QUALITY_SLOW_FRAMES 3
+#define QUALITY_RECOVER_RATIO 0.75f
+
+//  With vsync on a frame only counts as slow once it has missed a refresh
+#define VSYNC_MISS_RATIO 1.5f
+#define REDUCED_MASK_SCALE 0.5f
+
 typedef struct
 {
-    float duration;
+    float inverse_duration;
+    const float *easing_table;
     Texture2D start_texture;
     Texture2D end_texture;
     RenderTexture2D transition_texture;
     float start_value;
-    float end_value;
+    float value_range;
+    Vector2 centre;
+    float mask_scale;
+    void (*draw)(float value);
 } TRANSITION_DATA;
 
 static bool transition_active = false;
@@ -32,32 +54,74 @@ static Image start_screen;
 static Texture2D end_screen;
 static RenderTexture2D screen_texture;
 
-static struct timeval transition_start_time;
-
-static void (*current_transition)(void); 
-static void init_fade(void);
-static void run_fade(void);
-static void draw_fade(Color start_tint, Color end_tint);
-static void init_slide_left_overlap(void);
-static void run_slide_left_overlap(void);
-static void draw_slide_left_overlap(float end_x);
-static void init_slide_right_overlap(void);
-static void run_slide_right_overlap(void);
-static void draw_slide_right_overlap(float end_x);
-static void init_slide_left(void);
-static void run_slide_left(void);
-static void draw_slide_left(float start_x, float end_x);
-static void init_slide_right(void);
-static void run_slide_right(void);
-static void draw_slide_right(float start_x, float end_x);
-static void init_circle_expand(void);
-static void run_circle_expand(void);
+//  Kept between transitions and only reloaded when the screen size changes
+static Texture2D start_texture;
+static RenderTexture2D mask_texture;
+static RenderTexture2D frame_texture;
+
+static TRANSITION_INTERRUPT interrupt_mode = TRANSITION_INTERRUPT_RETARGET;
+static bool capturing_frame = false;
+static TRANSITION_RESOURCES resources = { 0 };
+
+//  Used instead of the GPU draws when compositing on the CPU
+static TRANSITION_COMPOSITOR compositor = TRANSITION_COMPOSITOR_GPU;
+static bool cpu_composite_active = false;
+static Image end_image;
+static Image composite_image;
+static Texture2D composite_texture;
+
+//  Adapted as transitions run, 0 for the budget leaves the quality alone
+static float frame_budget = 0.0f;
+static TRANSITION_QUALITY quality = TRANSITION_QUALITY_FULL;
+static void (*quality_callback)(TRANSITION_QUALITY old_quality, TRANSITION_QUALITY new_quality, float frame_cost) = NULL;
+static float frame_cost = 0.0f;
+static float frame_limit = 0.0f;
+static double last_frame_time = 0.0;
+static int slow_frames = 0;
+static int frames_since_quality_change = 0;
+
+static float easing_tables[EASING_ALL][EASING_TABLE_SIZE + 2];
+static bool easing_tables_built = false;
+
+//  NULL for GetTime()
+static double (*transition_clock)(void) = NULL;
+static double transition_start_time = 0.0;
+
+static void init_transition(TRANSITION_PARAMS params, void (*draw)(float value), float start_value, float end_value);
+static void init_circle_mask(Vector2 centre);
+static float get_transition_value(bool *finished);
+static float get_eased_progress(float progress);
+static void build_easing_tables(void);
+static float get_covering_radius(Vector2 centre);
+static float get_frame_limit(void);
+static void measure_frame_cost(void);
+static void adapt_quality(void);
+static bool has_cheaper_quality(void);
+static void set_quality(TRANSITION_QUALITY new_quality);
+static void apply_quality(void);
+static void draw_fade(float alpha);
+static void draw_slide_overlap(float end_x);
+static void draw_slide(float end_x);
 static void draw_circle_expand(float radius);
-static void init_circle_contract(void);
-static void run_circle_contract(void);
 static void draw_circle_contract(float radius);
 static void end_transition(void);
 
+static void begin_transition_frame(void);
+static void end_transition_frame(void);
+static void capture_current_frame(void);
+static Texture2D load_start_texture(void);
+static void reuse_render_texture(RenderTexture2D *target, int width, int height);
+static void track_image(Image image);
+static void track_texture(Texture2D texture);
+static void release_image(Image *image);
+static void release_texture(Texture2D *texture);
+static void release_render_texture(RenderTexture2D *target);
+
+static void init_cpu_composite(void);
+static void draw_cpu_composite(void);
+static void end_cpu_composite(void);
+
+static double get_transition_clock_time(void);
 static void set_transition_start_time(void);
 static double get_transition_time_delta(void);
 
@@ -67,20 +131,91 @@ void set_transition_duration(float duration)
     transition_duration = duration;
 }
 
+//  Transitions follow this clock, so a replay can run them on recorded time
+//  A running transition keeps its progress, as its start time moves onto the new clock
+void set_transition_clock(double (*clock)(void))
+{
+    double old_time = get_transition_clock_time();
+
+    transition_clock = clock;
+
+    if (transition_active)
+    {
+        transition_start_time += get_transition_clock_time() - old_time;
+    }
+}
+
 bool is_transition_active(void)
 {
     return transition_active;
 }
 
+//  Only takes effect from the next transition started
+void set_transition_compositor(TRANSITION_COMPOSITOR transition_compositor)
+{
+    compositor = transition_compositor;
+}
+
+TRANSITION_COMPOSITOR get_transition_compositor(void)
+{
+    return compositor;
+}
+
+void set_transition_interrupt(TRANSITION_INTERRUPT mode)
+{
+    interrupt_mode = mode;
+}
+
+TRANSITION_INTERRUPT get_transition_interrupt(void)
+{
+    return interrupt_mode;
+}
+
+void set_transition_frame_budget(float seconds)
+{
+    frame_budget = seconds;
+    frame_limit = get_frame_limit();
+
+    if (frame_budget <= 0.0f)
+    {
+        set_quality(TRANSITION_QUALITY_FULL);
+    }
+}
+
+TRANSITION_QUALITY get_transition_quality(void)
+{
+    return quality;
+}
+
+float get_transition_frame_cost(void)
+{
+    return frame_cost;
+}
+
+void set_transition_quality_callback(void (*callback)(TRANSITION_QUALITY old_quality, TRANSITION_QUALITY new_quality, float frame_cost))
+{
+    quality_callback = callback;
+}
+
 void set_transition_start_screen(void)
 {
+    if (transition_active)
+    {
+        //  Interrupted, so the next transition starts from the blended frame currently shown
+        capture_current_frame();
+        return;
+    }
+
+    release_image(&start_screen);
+
     start_screen = LoadImageFromScreen();
+    track_image(start_screen);
 }
 
 void set_transition_end_screen(void (*render_method)(void))
 {
-    screen_texture = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
-    
+    reuse_render_texture(&screen_texture, GetScreenWidth(), GetScreenHeight());
+
     BeginTextureMode(screen_texture);
         render_method();
     EndTextureMode();
@@ -90,51 +225,141 @@ void set_transition_end_screen(void (*render_method)(void))
 
 void start_transition(TRANSITION_TYPE type)
 {
+    start_transition_with_params(type, get_default_transition_params());
+}
+
+void start_transition_with_params(TRANSITION_TYPE type, TRANSITION_PARAMS params)
+{
+    float width = (float)GetScreenWidth();
+    float height = (float)GetScreenHeight();
+    Vector2 centre = (Vector2){ params.centre.x * width, params.centre.y * height };
+
+    //  Started over a running transition, whose CPU composite would otherwise leak
+    end_cpu_composite();
+
+    if (compositor == TRANSITION_COMPOSITOR_CPU && type != TRANSITION_NONE && type < TRANSITION_ALL)
+    {
+        init_cpu_composite();
+    }
+
+    //  The refresh rate may have changed since the budget was set, eg the window moved to another monitor
+    frame_limit = get_frame_limit();
+
+    //  Load has to have eased off since the last transition to win back a level
+    if (frame_budget > 0.0f && quality > TRANSITION_QUALITY_FULL && frame_cost < frame_limit * QUALITY_RECOVER_RATIO)
+    {
+        set_quality(quality - 1);
+    }
+
+    //  Circles cost an extra offscreen pass on the GPU, but are cheaper than a fade on the CPU
+    if (quality == TRANSITION_QUALITY_MINIMAL && cpu_composite_active == false && (type == TRANSITION_CIRCLE_EXPAND || type == TRANSITION_CIRCLE_CONTRACT))
+    {
+        type = TRANSITION_FADE;
+    }
+
     switch(type)
     {
         case TRANSITION_FADE:
-            transition_active = true;
-            init_fade();
+            init_transition(params, &draw_fade, 0.0f, 255.0f);
             break;
 
         case TRANSITION_SLIDE_LEFT_OVERLAP:
-            transition_active = true;
-            init_slide_left_overlap();
+            init_transition(params, &draw_slide_overlap, -width, 0.0f);
             break;
 
         case TRANSITION_SLIDE_RIGHT_OVERLAP:
-            transition_active = true;
-            init_slide_right_overlap();
+            init_transition(params, &draw_slide_overlap, width, 0.0f);
             break;
 
         case TRANSITION_SLIDE_LEFT:
-            transition_active = true;
-            init_slide_left();
+            init_transition(params, &draw_slide, -width, 0.0f);
             break;
 
         case TRANSITION_SLIDE_RIGHT:
-            transition_active = true;
-            init_slide_right();
+            init_transition(params, &draw_slide, width, 0.0f);
             break;
 
         case TRANSITION_CIRCLE_EXPAND:
-            transition_active = true;
-            init_circle_expand();
+            init_transition(params, &draw_circle_expand, 0.0f, get_covering_radius(centre));
+            init_circle_mask(centre);
             break;
 
         case TRANSITION_CIRCLE_CONTRACT:
-            transition_active = true;
-            init_circle_contract();
+            init_transition(params, &draw_circle_contract, get_covering_radius(centre), 0.0f);
+            init_circle_mask(centre);
             break;
 
         default:
             transition_active = false;
+            end_cpu_composite();
+    }
+
+    //  Only the CPU compositor needs the pixels once they are uploaded
+    if (cpu_composite_active == false)
+    {
+        release_image(&start_screen);
     }
 }
 
+TRANSITION_PARAMS get_default_transition_params(void)
+{
+    return (TRANSITION_PARAMS){ 0.0f, EASING_LINEAR, (Vector2){ 0.5f, 0.5f } };
+}
+
 void run_transition(void)
 {
-    current_transition();
+    bool finished = false;
+
+    measure_frame_cost();
+    adapt_quality();
+
+    data.draw(get_transition_value(&finished));
+
+    if (finished)
+    {
+        end_transition();
+    }
+}
+
+void stop_transition(void)
+{
+    end_transition();
+}
+
+void unload_transition_resources(void)
+{
+    end_transition();
+
+    release_texture(&start_texture);
+    release_render_texture(&screen_texture);
+    release_render_texture(&mask_texture);
+    release_render_texture(&frame_texture);
+}
+
+TRANSITION_RESOURCES get_transition_resources(void)
+{
+    return resources;
+}
+
+//  Only the reusable textures may outlive a transition, so rapid scene changes can't grow them
+bool check_transition_invariants(void)
+{
+    if (resources.images < 0 || resources.textures < 0 || resources.render_textures < 0)
+    {
+        return false;
+    }
+
+    if (cpu_composite_active && transition_active == false)
+    {
+        return false;
+    }
+
+    if (transition_active)
+    {
+        return resources.images <= 3 && resources.textures <= 2 && resources.render_textures <= 3;
+    }
+
+    return resources.images == 0 && resources.textures <= 1 && resources.render_textures <= 3;
 }
 
 TRANSITION_TYPE get_random_transition(void)
@@ -151,403 +376,536 @@ TRANSITION_TYPE get_random_transition(void)
      return (TRANSITION_TYPE)(rand() % (int)TRANSITION_ALL);
 }
 
-static void init_fade(void)
+//  Every transition type moves a single value from start_value to end_value, which its draw method renders
+static void init_transition(TRANSITION_PARAMS params, void (*draw)(float value), float start_value, float end_value)
 {
-    current_transition = &run_fade;
+    float duration = (params.duration > 0.0f) ? params.duration : transition_duration;
+
+    if (easing_tables_built == false)
+    {
+        build_easing_tables();
+    }
 
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
+    //  A duration that is still not positive makes the transition instant, rather than dividing by it
+    data.inverse_duration = (duration > 0.0f) ? 1.0f / duration : 0.0f;
+    data.easing_table = easing_tables[(params.easing < EASING_ALL) ? params.easing : EASING_LINEAR];
+    //  The CPU compositor draws from the captured pixels, so the start screen isn't uploaded
+    data.start_texture = cpu_composite_active ? (Texture2D){ 0 } : load_start_texture();
     data.end_texture = end_screen;
     data.transition_texture = (RenderTexture2D){ 0 };
-    data.start_value = 255;
-    data.end_value = 0;
+    data.start_value = start_value;
+    data.value_range = end_value - start_value;
+    data.draw = draw;
+
+    transition_active = true;
+
+    last_frame_time = 0.0;
+    slow_frames = 0;
+    frames_since_quality_change = 0;
 
     set_transition_start_time();
 }
 
-static void run_fade(void)
+static void init_circle_mask(Vector2 centre)
 {
-    Color start_tint = WHITE;
-    Color end_tint = WHITE;
-    float time_delta = (float)get_transition_time_delta();
-    float variance = (255 / (data.duration / time_delta));
-    float start_variance = data.start_value - variance;
-    float end_variance = data.end_value + variance;
+    data.centre = centre;
+    data.mask_scale = (quality >= TRANSITION_QUALITY_REDUCED) ? REDUCED_MASK_SCALE : 1.0f;
 
-    if (start_variance < 0.0f || end_variance > 255.0f)
+    if (cpu_composite_active == false)
     {
-        start_tint.a = (unsigned char)data.end_value;
-        end_tint.a = (unsigned char)data.start_value;
-
-        draw_fade(start_tint, end_tint);
-        end_transition();
-    }
-    else
-    {
-        start_tint.a = (unsigned char)start_variance;
-        end_tint.a = (unsigned char)end_variance;
-
-        draw_fade(start_tint, end_tint);
+        reuse_render_texture(&mask_texture, (int)(GetScreenWidth() * data.mask_scale), (int)(GetScreenHeight() * data.mask_scale));
+        SetTextureFilter(mask_texture.texture, TEXTURE_FILTER_BILINEAR);
+        data.transition_texture = mask_texture;
     }
 }
 
-static void draw_fade(Color start_tint, Color end_tint)
+static float get_transition_value(bool *finished)
 {
-    // RenderTextures have an opposite Y axis
-    Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
-    Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
+    float progress = (data.inverse_duration > 0.0f) ? (float)get_transition_time_delta() * data.inverse_duration : 1.0f;
 
-    BeginDrawing();
-        ClearBackground(BLACK);
+    *finished = (progress >= 1.0f);
 
-        DrawTexture(data.start_texture, 0, 0, start_tint);
-        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, end_tint);
-    EndDrawing();
+    return data.start_value + (data.value_range * get_eased_progress(progress));
 }
 
-static void init_slide_left_overlap(void)
+//  Linear interpolation between table entries, the extra entry at the end means 1.0 needs no special case
+//  Progress is clamped, as a clock that steps back or jumps ahead would index outside the table
+static float get_eased_progress(float progress)
 {
-    current_transition = &run_slide_left_overlap;
-
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
-    data.end_texture = end_screen;
-    data.transition_texture = (RenderTexture2D){ 0 };
-    data.start_value = (float)GetScreenWidth() * -1.0f;
-    data.end_value = 0.0f;
+    float position = fminf(fmaxf(progress, 0.0f), 1.0f) * EASING_TABLE_SIZE;
+    int index = (int)position;
+    float fraction = position - (float)index;
 
-    set_transition_start_time();
+    return data.easing_table[index] + ((data.easing_table[index + 1] - data.easing_table[index]) * fraction);
 }
 
-static void run_slide_left_overlap(void)
+static void build_easing_tables(void)
 {
-    float time_delta = (float)get_transition_time_delta();
-    float variance = (GetScreenWidth() / (data.duration / time_delta));
-    float start_variance = data.start_value + variance;
-
-    if (start_variance >= data.end_value)
-    {
-        draw_slide_left_overlap(data.end_value);
-        end_transition();
-    }
-    else
+    for (int index = 0; index <= EASING_TABLE_SIZE + 1; index++)
     {
-        draw_slide_left_overlap(start_variance);
+        float t = (index > EASING_TABLE_SIZE) ? 1.0f : (float)index / (float)EASING_TABLE_SIZE;
+        float in_out = (t < 0.5f) ? (4.0f * t * t * t) : (1.0f - (powf((-2.0f * t) + 2.0f, 3.0f) / 2.0f));
+
+        easing_tables[EASING_LINEAR][index] = t;
+        easing_tables[EASING_IN][index] = t * t;
+        easing_tables[EASING_OUT][index] = 1.0f - ((1.0f - t) * (1.0f - t));
+        easing_tables[EASING_IN_OUT][index] = in_out;
+        easing_tables[EASING_SMOOTH][index] = t * t * (3.0f - (2.0f * t));
     }
+
+    easing_tables_built = true;
 }
 
-static void draw_slide_left_overlap(float end_x)
+//  Far enough from the centre to reach every corner of the screen
+static float get_covering_radius(Vector2 centre)
 {
-    // RenderTextures have an opposite Y axis
-    Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
-    Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
+    float x = fmaxf(centre.x, (float)GetScreenWidth() - centre.x);
+    float y = fmaxf(centre.y, (float)GetScreenHeight() - centre.y);
 
-    BeginDrawing();
-        ClearBackground(BLACK);
-
-        DrawTexture(data.start_texture, 0, 0, WHITE);
-        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ end_x, 0 }, 0.0f, WHITE);
-    EndDrawing();
+    return sqrtf((x * x) + (y * y));
 }
 
-static void init_slide_right_overlap(void)
+//  Vsync holds every frame to the refresh interval however little it costs, so a budget below that can't be met
+//  and only frames that miss a refresh count against it
+static float get_frame_limit(void)
 {
-    current_transition = &run_slide_right_overlap;
+    int refresh_rate = GetMonitorRefreshRate(GetCurrentMonitor());
 
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
-    data.end_texture = end_screen;
-    data.transition_texture = (RenderTexture2D){ 0 };
-    data.start_value = (float)GetScreenWidth();
-    data.end_value = 0.0f;
+    if (IsWindowState(FLAG_VSYNC_HINT) && refresh_rate > 0)
+    {
+        return fmaxf(frame_budget, VSYNC_MISS_RATIO / (float)refresh_rate);
+    }
 
-    set_transition_start_time();
+    return frame_budget;
 }
 
-static void run_slide_right_overlap(void)
+//  The whole interval between transition frames, as the GPU's share of the work only shows up in the swap
+static void measure_frame_cost(void)
 {
-    float time_delta = (float)get_transition_time_delta();
-    float variance = (data.start_value / (data.duration / time_delta));
-    float start_variance = data.start_value - variance;
+    double now = GetTime();
 
-    if (start_variance <= data.end_value)
+    if (last_frame_time > 0.0)
     {
-        draw_slide_right_overlap(data.end_value);
-        end_transition();
+        float interval = (float)(now - last_frame_time);
+
+        frame_cost += (interval - frame_cost) * FRAME_COST_SMOOTHING;
+
+        if (interval > frame_limit)
+        {
+            slow_frames++;
+        }
     }
-    else
+
+    last_frame_time = now;
+}
+
+//  Drops a level once a few frames have run over the limit since the last change
+static void adapt_quality(void)
+{
+    frames_since_quality_change++;
+
+    if (frame_budget > 0.0f && slow_frames >= QUALITY_SLOW_FRAMES && quality < TRANSITION_QUALITY_MINIMAL && frames_since_quality_change >= QUALITY_SETTLE_FRAMES && has_cheaper_quality())
     {
-        draw_slide_right_overlap(start_variance);
+        set_quality(quality + 1);
+        apply_quality();
     }
 }
 
-static void draw_slide_right_overlap(float end_x)
+static void set_quality(TRANSITION_QUALITY new_quality)
 {
-    // RenderTextures have an opposite Y axis
-    Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
-    Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
+    TRANSITION_QUALITY old_quality = quality;
 
-    BeginDrawing();
-        ClearBackground(BLACK);
+    if (new_quality == old_quality)
+    {
+        return;
+    }
 
-        DrawTexture(data.start_texture, 0, 0, WHITE);
-        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ end_x, 0 }, 0.0f, WHITE);
-    EndDrawing();
+    quality = new_quality;
+    frames_since_quality_change = 0;
+    slow_frames = 0;
+
+    if (quality_callback != NULL)
+    {
+        quality_callback(old_quality, new_quality, frame_cost);
+    }
 }
 
-static void init_slide_left(void)
+//  Only circles drawn on the GPU have cheaper levels, fades and slides are already a single pass
+//  A level isn't dropped for them, as it would only be reported and then take circles down without measuring them
+static bool has_cheaper_quality(void)
 {
-    current_transition = &run_slide_left;
-
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
-    data.end_texture = end_screen;
-    data.transition_texture = (RenderTexture2D){ 0 };
-    data.start_value = (float)GetScreenWidth() * -1.0f;
-    data.end_value = 0.0f;
-
-    set_transition_start_time();
+    return cpu_composite_active == false && (data.draw == &draw_circle_expand || data.draw == &draw_circle_contract);
 }
 
-static void run_slide_left(void)
+//  Degrades the running transition in place, its progress carries on from the same point
+static void apply_quality(void)
 {
-    float time_delta = (float)get_transition_time_delta();
-    float variance = ((float)GetScreenWidth() / (data.duration / time_delta));
-    float start_variance = data.start_value + variance;
+    if (has_cheaper_quality() == false)
+    {
+        return;
+    }
 
-    if (start_variance >= data.end_value)
+    if (quality == TRANSITION_QUALITY_MINIMAL)
     {
-        draw_slide_left(data.start_value, data.end_value);
-        end_transition();
+        data.draw = &draw_fade;
+        data.start_value = 0.0f;
+        data.value_range = 255.0f;
+        data.transition_texture = (RenderTexture2D){ 0 };
     }
     else
     {
-        float start_x = data.start_value - start_variance;
-        float end_x = start_variance;
-
-        draw_slide_left(start_x, end_x);
+        init_circle_mask(data.centre);
     }
 }
 
-static void draw_slide_left(float start_x, float end_x)
+static void draw_fade(float alpha)
 {
+    Color start_tint = WHITE;
+    Color end_tint = WHITE;
+
+    start_tint.a = (unsigned char)(255.0f - alpha);
+    end_tint.a = (unsigned char)alpha;
+
+    if (cpu_composite_active)
+    {
+        composite_fade(composite_image.data, start_screen.data, end_image.data, composite_image.width * composite_image.height, start_tint.a, end_tint.a);
+        draw_cpu_composite();
+        return;
+    }
+
     // RenderTextures have an opposite Y axis
     Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
     Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
 
-    BeginDrawing();
+    begin_transition_frame();
         ClearBackground(BLACK);
 
-        DrawTexture(data.start_texture, start_x, 0, WHITE);
-        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ end_x, 0 }, 0.0f, WHITE);
-    EndDrawing();
+        DrawTexture(data.start_texture, 0, 0, start_tint);
+        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, end_tint);
+    end_transition_frame();
 }
 
-static void init_slide_right(void)
+//  The end screen slides over the start screen, end_x being its origin so it moves in from the opposite side
+static void draw_slide_overlap(float end_x)
 {
-    current_transition = &run_slide_right;
+    if (cpu_composite_active)
+    {
+        composite_slide(composite_image.data, start_screen.data, end_image.data, composite_image.width, composite_image.height, 0, -(int)end_x);
+        draw_cpu_composite();
+        return;
+    }
 
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
-    data.end_texture = end_screen;
-    data.transition_texture = (RenderTexture2D){ 0 };
-    data.start_value = (float)GetScreenWidth();
-    data.end_value = 0.0f;
+    // RenderTextures have an opposite Y axis
+    Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
+    Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
 
-    set_transition_start_time();
+    begin_transition_frame();
+        ClearBackground(BLACK);
+
+        DrawTexture(data.start_texture, 0, 0, WHITE);
+        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ end_x, 0 }, 0.0f, WHITE);
+    end_transition_frame();
 }
 
-static void run_slide_right(void)
+//  As draw_slide_overlap(), but the start screen is pushed out ahead of the end screen
+static void draw_slide(float end_x)
 {
-    float time_delta = (float)get_transition_time_delta();
-    float variance = (data.start_value / (data.duration / time_delta));
-    float start_variance = data.start_value - variance;
+    float start_x = data.start_value - end_x;
 
-    if (start_variance <= data.end_value)
-    {
-        draw_slide_right(data.start_value, data.end_value);
-        end_transition();
-    }
-    else
+    if (cpu_composite_active)
     {
-        float start_x = data.start_value - start_variance;
-        float end_x = start_variance;
-
-        draw_slide_right(start_x, end_x);
+        composite_slide(composite_image.data, start_screen.data, end_image.data, composite_image.width, composite_image.height, (int)start_x, -(int)end_x);
+        draw_cpu_composite();
+        return;
     }
-}
 
-static void draw_slide_right(float start_x, float end_x)
-{
     // RenderTextures have an opposite Y axis
     Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
     Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
 
-    BeginDrawing();
+    begin_transition_frame();
         ClearBackground(BLACK);
 
         DrawTexture(data.start_texture, start_x, 0, WHITE);
         DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ end_x, 0 }, 0.0f, WHITE);
-    EndDrawing();
+    end_transition_frame();
 }
 
-static void init_circle_expand(void)
+static void draw_circle_expand(float radius)
 {
-    float x = (float)GetScreenWidth();
-    float y = (float)GetScreenHeight();
-    float radius = 0.5f * sqrtf((x * x) + (y * y));
+    if (cpu_composite_active)
+    {
+        composite_circle(composite_image.data, start_screen.data, end_image.data, composite_image.width, composite_image.height, data.centre.x, data.centre.y, radius);
+        draw_cpu_composite();
+        return;
+    }
 
-    current_transition = &run_circle_expand;
+    // RenderTextures have an opposite Y axis
+    Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
+    Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
 
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
-    data.end_texture = end_screen;
-    data.transition_texture = LoadRenderTexture(x, y);
-    data.start_value = 0.0f;
-    data.end_value = radius;
+    // The mask may be drawn at a lower resolution and scaled up
+    Rectangle rect_mask_source = (Rectangle){ 0, 0, (float)data.transition_texture.texture.width, -(float)data.transition_texture.texture.height };
+    Rectangle rect_mask_dest = (Rectangle){ 0, 0, (float)data.transition_texture.texture.width, (float)data.transition_texture.texture.height };
+    Rectangle rect_start_source = (Rectangle){ 0, 0, (float)data.start_texture.width, (float)data.start_texture.height };
 
-    set_transition_start_time();
+    BeginTextureMode(data.transition_texture);
+        ClearBackground(BLACK);
+        DrawTexturePro(data.start_texture, rect_start_source, rect_mask_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+
+        // Force the blend mode to only set the alpha of the destination
+        rlSetBlendFactors(GL_SRC_ALPHA, GL_SRC_ALPHA, GL_MIN);
+        rlSetBlendMode(BLEND_CUSTOM);
+
+        // Draw a blank 'hole' in our texture
+        DrawCircleV(Vector2Scale(data.centre, data.mask_scale), radius * data.mask_scale, BLANK);
+
+        // Go back to normal
+        rlSetBlendMode(BLEND_ALPHA);
+    EndTextureMode();
+
+    begin_transition_frame();
+        ClearBackground(BLACK);
+
+        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+        DrawTexturePro(data.transition_texture.texture, rect_mask_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    end_transition_frame();
 }
 
-static void run_circle_expand(void)
+static void draw_circle_contract(float radius)
 {
-    float time_delta = (float)get_transition_time_delta();
-    float variance = ((float)data.end_value / (data.duration / time_delta));
-    float current_radius = data.start_value + variance;
-
-    if (current_radius >= data.end_value)
-    {
-        draw_circle_expand(data.end_value);
-        end_transition();
-    }
-    else
+    if (cpu_composite_active)
     {
-        draw_circle_expand(current_radius);
+        composite_circle(composite_image.data, end_image.data, start_screen.data, composite_image.width, composite_image.height, data.centre.x, data.centre.y, radius);
+        draw_cpu_composite();
+        return;
     }
-}
 
-static void draw_circle_expand(float radius)
-{
     // RenderTextures have an opposite Y axis
     Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
     Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
 
+    // The mask may be drawn at a lower resolution and scaled up
+    Rectangle rect_mask_source = (Rectangle){ 0, 0, (float)data.transition_texture.texture.width, -(float)data.transition_texture.texture.height };
+    Rectangle rect_mask_dest = (Rectangle){ 0, 0, (float)data.transition_texture.texture.width, (float)data.transition_texture.texture.height };
+
     BeginTextureMode(data.transition_texture);
         ClearBackground(BLACK);
-        DrawTexture(data.start_texture, 0, 0, WHITE);
+        DrawTexturePro(data.end_texture, rect_end_source, rect_mask_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
 
         // Force the blend mode to only set the alpha of the destination
         rlSetBlendFactors(GL_SRC_ALPHA, GL_SRC_ALPHA, GL_MIN);
         rlSetBlendMode(BLEND_CUSTOM);
 
         // Draw a blank 'hole' in our texture
-        DrawCircle(GetScreenWidth() / 2, GetScreenHeight() / 2, radius, BLANK);
+        DrawCircleV(Vector2Scale(data.centre, data.mask_scale), radius * data.mask_scale, BLANK);
 
         // Go back to normal
         rlSetBlendMode(BLEND_ALPHA);
     EndTextureMode();
 
-    BeginDrawing();
+    begin_transition_frame();
         ClearBackground(BLACK);
 
-        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
-        DrawTexturePro(data.transition_texture.texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
-    EndDrawing();
+        DrawTexture(data.start_texture, 0, 0, WHITE);
+        DrawTexturePro(data.transition_texture.texture, rect_mask_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    end_transition_frame();
 }
 
-static void init_circle_contract(void)
+//  The textures are kept for the next transition, so only the captured screen is released
+static void end_transition(void)
 {
-    float x = (float)GetScreenWidth();
-    float y = (float)GetScreenHeight();
-    float radius = 0.5f * sqrtf((x * x) + (y * y));
-
-    current_transition = &run_circle_contract;
+    release_image(&start_screen);
 
-    data.duration = transition_duration;
-    data.start_texture = LoadTextureFromImage(start_screen);
-    data.end_texture = end_screen;
-    data.transition_texture = LoadRenderTexture(x, y);
-    data.start_value = radius;
-    data.end_value = 0.0f;
+    end_cpu_composite();
 
-    set_transition_start_time();
+    transition_active = false;
 }
 
-static void run_circle_contract(void)
+static void begin_transition_frame(void)
 {
-    float time_delta = (float)get_transition_time_delta();
-    float variance = ((float)data.start_value / (data.duration / time_delta));
-    float current_radius = data.start_value - variance;
+    if (capturing_frame)
+    {
+        BeginTextureMode(frame_texture);
+    }
+    else
+    {
+        BeginDrawing();
+    }
+}
 
-    if (current_radius <= data.end_value)
+static void end_transition_frame(void)
+{
+    if (capturing_frame)
     {
-        draw_circle_contract(data.end_value);
-        end_transition();
+        EndTextureMode();
     }
     else
     {
-        draw_circle_contract(current_radius);
+        capture_frame();
+        EndDrawing();
     }
 }
 
-static void draw_circle_contract(float radius)
+static void capture_current_frame(void)
 {
+    reuse_render_texture(&frame_texture, GetScreenWidth(), GetScreenHeight());
+
+    bool finished = false;
+
+    //  Redraw the current frame offscreen
+    capturing_frame = true;
+    data.draw(get_transition_value(&finished));
+    capturing_frame = false;
+
+    end_transition();
+
+    start_screen = LoadImageFromTexture(frame_texture.texture);
+    track_image(start_screen);
+
     // RenderTextures have an opposite Y axis
-    Rectangle rect_end_source = (Rectangle){ 0, 0, (float)data.end_texture.width, -(float)data.end_texture.height };
-    Rectangle rect_end_dest = (Rectangle){ 0, 0, (float)data.end_texture.width, (float)data.end_texture.height };
+    ImageFlipVertical(&start_screen);
+}
 
-    BeginTextureMode(data.transition_texture);
-        ClearBackground(BLACK);
-        DrawTexturePro(data.end_texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+static Texture2D load_start_texture(void)
+{
+    if (start_texture.id > 0 && start_texture.width == start_screen.width && start_texture.height == start_screen.height && start_texture.format == start_screen.format)
+    {
+        UpdateTexture(start_texture, start_screen.data);
+        return start_texture;
+    }
 
-        // Force the blend mode to only set the alpha of the destination
-        rlSetBlendFactors(GL_SRC_ALPHA, GL_SRC_ALPHA, GL_MIN);
-        rlSetBlendMode(BLEND_CUSTOM);
+    release_texture(&start_texture);
 
-        // Draw a blank 'hole' in our texture
-        DrawCircle(GetScreenWidth() / 2, GetScreenHeight() / 2, radius, BLANK);
+    start_texture = LoadTextureFromImage(start_screen);
+    track_texture(start_texture);
 
-        // Go back to normal
-        rlSetBlendMode(BLEND_ALPHA);
-    EndTextureMode();
+    return start_texture;
+}
 
-    BeginDrawing();
-        ClearBackground(BLACK);
+static void reuse_render_texture(RenderTexture2D *target, int width, int height)
+{
+    if (target->id > 0 && target->texture.width == width && target->texture.height == height)
+    {
+        return;
+    }
 
-        DrawTexture(data.start_texture, 0, 0, WHITE);
-        DrawTexturePro(data.transition_texture.texture, rect_end_source, rect_end_dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
-    EndDrawing();
+    release_render_texture(target);
+
+    *target = load_render_target(width, height);
+    resources.render_textures++;
 }
 
-static void end_transition(void)
+static void track_image(Image image)
 {
-    UnloadImage(start_screen);
-    UnloadTexture(end_screen);
+    resources.images++;
+    track_memory_alloc(MEMORY_SNAPSHOTS, GetPixelDataSize(image.width, image.height, image.format));
+}
 
-    UnloadTexture(data.start_texture);
-    UnloadTexture(data.end_texture);  // Extraneous as end_screen is assigned to data.end_texture
+static void track_texture(Texture2D texture)
+{
+    resources.textures++;
+    track_memory_alloc(MEMORY_TEXTURES, GetPixelDataSize(texture.width, texture.height, texture.format));
+}
 
-    UnloadRenderTexture(data.transition_texture);
-    UnloadRenderTexture(screen_texture);
+static void release_image(Image *image)
+{
+    if (image->data != NULL)
+    {
+        track_memory_free(MEMORY_SNAPSHOTS, GetPixelDataSize(image->width, image->height, image->format));
 
-    transition_active = false;
+        UnloadImage(*image);
+        *image = (Image){ 0 };
+        resources.images--;
+    }
 }
 
-static void set_transition_start_time(void)
+static void release_texture(Texture2D *texture)
 {
-    gettimeofday(&transition_start_time, NULL);
+    if (texture->id > 0)
+    {
+        track_memory_free(MEMORY_TEXTURES, GetPixelDataSize(texture->width, texture->height, texture->format));
+
+        UnloadTexture(*texture);
+        *texture = (Texture2D){ 0 };
+        resources.textures--;
+    }
 }
 
-static double get_transition_time_delta(void)
+static void release_render_texture(RenderTexture2D *target)
+{
+    if (target->id > 0)
+    {
+        unload_render_target(target);
+        resources.render_textures--;
+    }
+}
+
+static void init_cpu_composite(void)
 {
-    struct timeval transition_end_time;
-    double delta_usecs;
-    double delta;
+    end_image = LoadImageFromTexture(end_screen);
 
-    gettimeofday(&transition_end_time, NULL);
+    // RenderTextures have an opposite Y axis
+    ImageFlipVertical(&end_image);
+    ImageFormat(&end_image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    track_image(end_image);
+
+    //  Screen captures are already RGBA, so this never changes the tracked size
+    ImageFormat(&start_screen, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    //  A high DPI screen captures at a different size to the end screen, so stay on the GPU
+    if (end_image.width != start_screen.width || end_image.height != start_screen.height)
+    {
+        release_image(&end_image);
+        return;
+    }
 
-    delta_usecs = (double)(transition_end_time.tv_usec - transition_start_time.tv_usec) / 1000000.0;
-    delta = (double)(transition_end_time.tv_sec - transition_start_time.tv_sec) + delta_usecs;
+    composite_image = ImageCopy(start_screen);
+    track_image(composite_image);
+
+    composite_texture = LoadTextureFromImage(composite_image);
+    track_texture(composite_texture);
+
+    cpu_composite_active = true;
+}
+
+static void draw_cpu_composite(void)
+{
+    UpdateTexture(composite_texture, composite_image.data);
 
-    return delta;
+    begin_transition_frame();
+        DrawTexture(composite_texture, 0, 0, WHITE);
+    end_transition_frame();
 }
+
+static void end_cpu_composite(void)
+{
+    if (cpu_composite_active == false)
+    {
+        return;
+    }
+
+    release_image(&end_image);
+    release_image(&composite_image);
+    release_texture(&composite_texture);
+
+    cpu_composite_active = false;
+}
+
+//  GetTime() is monotonic, so a change to the wall clock can't stall or skip a transition
+static double get_transition_clock_time(void)
+{
+    return (transition_clock != NULL) ? transition_clock() : GetTime();
+}
+
+static void set_transition_start_time(void)
+{
+    transition_start_time = get_transition_clock_time();
+}
+
+static double get_transition_time_delta(void)
+{
+    return get_transition_clock_time() - transition_start_time;
+}
+
+#endif
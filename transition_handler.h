@@ -16,15 +16,81 @@ typedef enum
     TRANSITION_ALL
 } TRANSITION_TYPE;
 
+typedef enum
+{
+    TRANSITION_COMPOSITOR_GPU = 0,
+    TRANSITION_COMPOSITOR_CPU
+} TRANSITION_COMPOSITOR;
+
+//  What happens when a new transition is asked for while one is still running
+typedef enum
+{
+    TRANSITION_INTERRUPT_RETARGET = 0,
+    TRANSITION_INTERRUPT_QUEUE
+} TRANSITION_INTERRUPT;
+
+//  Each level down is taken when circle transition frames run over the frame budget, REDUCED halves the mask
+//  resolution and MINIMAL draws a fade instead, fades and slides have nothing cheaper so stay as they are
+typedef enum
+{
+    TRANSITION_QUALITY_FULL = 0,
+    TRANSITION_QUALITY_REDUCED,
+    TRANSITION_QUALITY_MINIMAL
+} TRANSITION_QUALITY;
+
+typedef enum
+{
+    EASING_LINEAR = 0,
+    EASING_IN,
+    EASING_OUT,
+    EASING_IN_OUT,
+    EASING_SMOOTH,
+    EASING_ALL
+} TRANSITION_EASING;
+
+//  A duration of 0 uses set_transition_duration(), the centre is a fraction of the screen size
+typedef struct
+{
+    float duration;
+    TRANSITION_EASING easing;
+    Vector2 centre;
+} TRANSITION_PARAMS;
+
+typedef struct
+{
+    int images;
+    int textures;
+    int render_textures;
+} TRANSITION_RESOURCES;
+
 static const float DEFAULT_TRANSITION_DURATION = 5.0f;
 
 void set_transition_duration(float duration);
+//  Seconds, NULL goes back to GetTime(), a running transition carries on from where it was
+void set_transition_clock(double (*clock)(void));
 bool is_transition_active(void);
+void set_transition_compositor(TRANSITION_COMPOSITOR compositor);
+TRANSITION_COMPOSITOR get_transition_compositor(void);
+void set_transition_interrupt(TRANSITION_INTERRUPT mode);
+TRANSITION_INTERRUPT get_transition_interrupt(void);
+//  Seconds per frame, measured from one transition frame to the next, so it should be no less than SetTargetFPS() allows
+//  With vsync on, frames only count against it once they miss a refresh
+void set_transition_frame_budget(float seconds);
+TRANSITION_QUALITY get_transition_quality(void);
+float get_transition_frame_cost(void);
+void set_transition_quality_callback(void (*callback)(TRANSITION_QUALITY old_quality, TRANSITION_QUALITY new_quality, float frame_cost));
 
 void set_transition_start_screen(void);
 void set_transition_end_screen(void (*render_method)(void));
 void start_transition(TRANSITION_TYPE type);
+void start_transition_with_params(TRANSITION_TYPE type, TRANSITION_PARAMS params);
+TRANSITION_PARAMS get_default_transition_params(void);
 void run_transition(void);
+void stop_transition(void);
+void unload_transition_resources(void);
 TRANSITION_TYPE get_random_transition(void);
 
+TRANSITION_RESOURCES get_transition_resources(void);
+bool check_transition_invariants(void);
+
 #endif